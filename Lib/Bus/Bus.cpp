@@ -5,4 +5,14 @@ namespace RhAL
 Bus::~Bus()
 {
 }
+
+bool Bus::sendDataV(const struct iovec* iov, size_t count)
+{
+  bool isSuccess = true;
+  for (size_t i = 0; i < count; i++)
+  {
+    isSuccess = sendData(static_cast<uint8_t*>(iov[i].iov_base), iov[i].iov_len) && isSuccess;
+  }
+  return isSuccess;
+}
 }  // namespace RhAL
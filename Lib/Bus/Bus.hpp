@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <stdint.h>
+#include <sys/uio.h>
 
 namespace RhAL
 {
@@ -15,6 +16,14 @@ public:
    */
   virtual bool sendData(uint8_t* data, size_t size) = 0;
 
+  /**
+   * Sends the count buffers of given vector
+   * back to back (gather write).
+   * Default implementation calls sendData()
+   * for each buffer.
+   */
+  virtual bool sendDataV(const struct iovec* iov, size_t count);
+
   /**
    * Wait for size bytes to be available on the bus, expiring
    * after timeout.
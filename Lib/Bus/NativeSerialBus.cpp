@@ -0,0 +1,270 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <asm/termbits.h>
+#include <linux/serial.h>
+#include "NativeSerialBus.hpp"
+
+namespace RhAL
+{
+NativeSerialBus::NativeSerialBus(const std::string& port, unsigned int baudrate, bool isLowLatency,
+                                 unsigned int latencyTimer, bool isDrain)
+  : _port(port), _baudrate(baudrate), _isLowLatency(isLowLatency), _latencyTimer(latencyTimer), _isDrain(isDrain)
+  , _fd(-1)
+  , _iov()
+{
+  open();
+}
+
+NativeSerialBus::~NativeSerialBus()
+{
+  close();
+}
+
+void NativeSerialBus::open()
+{
+  _fd = ::open(_port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (_fd < 0)
+  {
+    throw std::runtime_error("NativeSerialBus open failed: " + _port + " " + std::strerror(errno));
+  }
+  // Raw mode, 8N1, no flow control
+  // and arbitrary baudrate
+  struct termios2 tio;
+  if (ioctl(_fd, TCGETS2, &tio) != 0)
+  {
+    int error = errno;
+    close();
+    throw std::runtime_error("NativeSerialBus TCGETS2 failed: " + _port + " " + std::strerror(error));
+  }
+  tio.c_iflag = 0;
+  tio.c_oflag = 0;
+  tio.c_lflag = 0;
+  tio.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS | CBAUD | (CBAUD << IBSHIFT));
+  tio.c_cflag |= CS8 | CREAD | CLOCAL | BOTHER | (BOTHER << IBSHIFT);
+  tio.c_ispeed = _baudrate;
+  tio.c_ospeed = _baudrate;
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  if (ioctl(_fd, TCSETS2, &tio) != 0)
+  {
+    int error = errno;
+    close();
+    throw std::runtime_error("NativeSerialBus TCSETS2 failed: " + _port + " " + std::strerror(error));
+  }
+  if (_isLowLatency)
+  {
+    setupLowLatency();
+  }
+  ioctl(_fd, TCFLSH, TCIOFLUSH);
+}
+
+void NativeSerialBus::close()
+{
+  if (_fd >= 0)
+  {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
+
+void NativeSerialBus::setupLowLatency()
+{
+  // Serial driver low latency flag
+  struct serial_struct serial;
+  if (ioctl(_fd, TIOCGSERIAL, &serial) == 0)
+  {
+    serial.flags |= ASYNC_LOW_LATENCY;
+    ioctl(_fd, TIOCSSERIAL, &serial);
+  }
+  // FTDI USB adapters buffer received
+  // bytes up to latency timer (16ms default)
+  char path[PATH_MAX];
+  if (_latencyTimer > 0 && realpath(_port.c_str(), path) != nullptr)
+  {
+    std::string name(path);
+    name = name.substr(name.find_last_of('/') + 1);
+    std::ofstream file("/sys/bus/usb-serial/devices/" + name + "/latency_timer");
+    if (file.is_open())
+    {
+      file << _latencyTimer << std::endl;
+    }
+  }
+}
+
+void NativeSerialBus::retryOpening()
+{
+  while (true)
+  {
+    close();
+    try
+    {
+      open();
+      break;
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cerr << "WARNING: NativeSerialBus::reopen(): " << e.what() << std::endl;
+    }
+    usleep(5000);
+  }
+}
+
+bool NativeSerialBus::sendData(uint8_t* data, size_t size)
+{
+  size_t sent = 0;
+  while (sent < size)
+  {
+    ssize_t n = ::write(_fd, data + sent, size - sent);
+    if (n > 0)
+    {
+      sent += n;
+    }
+    else if (n < 0 && errno == EAGAIN)
+    {
+      if (!waitWritable())
+      {
+        return false;
+      }
+    }
+    else if (n < 0 && errno != EINTR)
+    {
+      std::cerr << "WARNING: NativeSerialBus::sendData(): " << std::strerror(errno) << std::endl;
+      retryOpening();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NativeSerialBus::sendDataV(const struct iovec* iov, size_t count)
+{
+  _iov.assign(iov, iov + count);
+  size_t first = 0;
+  while (first < _iov.size())
+  {
+    // Skip fully written buffers
+    if (_iov[first].iov_len == 0)
+    {
+      first++;
+      continue;
+    }
+    ssize_t n = ::writev(_fd, _iov.data() + first, std::min(_iov.size() - first, (size_t)IOV_MAX));
+    if (n > 0)
+    {
+      // Advance over written bytes
+      size_t written = n;
+      while (written > 0 && written >= _iov[first].iov_len)
+      {
+        written -= _iov[first].iov_len;
+        first++;
+      }
+      if (written > 0)
+      {
+        _iov[first].iov_base = static_cast<uint8_t*>(_iov[first].iov_base) + written;
+        _iov[first].iov_len -= written;
+      }
+    }
+    else if (n < 0 && errno == EAGAIN)
+    {
+      if (!waitWritable())
+      {
+        return false;
+      }
+    }
+    else if (n < 0 && errno != EINTR)
+    {
+      std::cerr << "WARNING: NativeSerialBus::sendDataV(): " << std::strerror(errno) << std::endl;
+      retryOpening();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NativeSerialBus::waitWritable()
+{
+  // Output queue is full
+  struct pollfd fds = { _fd, POLLOUT, 0 };
+  return poll(&fds, 1, 1000) > 0;
+}
+
+bool NativeSerialBus::waitForData(double timeout)
+{
+  // ppoll is used for sub millisecond timeouts
+  if (timeout < 0.0)
+  {
+    timeout = 0.0;
+  }
+  struct timespec duration;
+  duration.tv_sec = (time_t)std::floor(timeout);
+  duration.tv_nsec = (long)((timeout - std::floor(timeout)) * 1e9);
+  struct pollfd fds = { _fd, POLLIN, 0 };
+  int result = ppoll(&fds, 1, &duration, nullptr);
+  if (result < 0 && errno != EINTR)
+  {
+    std::cerr << "WARNING: NativeSerialBus::waitForData(): " << std::strerror(errno) << std::endl;
+    retryOpening();
+    return false;
+  }
+  if (result > 0 && (fds.revents & (POLLERR | POLLHUP | POLLNVAL)) && !(fds.revents & POLLIN))
+  {
+    std::cerr << "WARNING: NativeSerialBus::waitForData(): port error" << std::endl;
+    retryOpening();
+    return false;
+  }
+  return result > 0;
+}
+
+size_t NativeSerialBus::available()
+{
+  int size = 0;
+  if (ioctl(_fd, FIONREAD, &size) != 0)
+  {
+    return 0;
+  }
+  return size;
+}
+
+size_t NativeSerialBus::readData(uint8_t* data, size_t size)
+{
+  ssize_t n = ::read(_fd, data, size);
+  if (n < 0)
+  {
+    if (errno != EAGAIN && errno != EINTR)
+    {
+      std::cerr << "WARNING: NativeSerialBus::readData(): " << std::strerror(errno) << std::endl;
+      retryOpening();
+    }
+    return 0;
+  }
+  return n;
+}
+
+void NativeSerialBus::flush()
+{
+  // Written bytes are handed to the driver
+  // by write(). Waiting for the physical
+  // transmission is only needed for software
+  // controlled half duplex adapters.
+  if (_isDrain)
+  {
+    ioctl(_fd, TCSBRK, 1);
+  }
+}
+
+void NativeSerialBus::clearInputBuffer()
+{
+  ioctl(_fd, TCFLSH, TCIFLUSH);
+}
+}  // namespace RhAL
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Bus.hpp"
+
+namespace RhAL
+{
+/**
+ * NativeSerialBus
+ *
+ * Serial port Bus implemented directly
+ * on a raw termios file descriptor.
+ * Any baudrate is supported through termios2
+ * (BOTHER). The port is configured for low
+ * latency: ASYNC_LOW_LATENCY serial flag and
+ * FTDI USB latency timer (when available).
+ * No internal locking is done, the Bus is
+ * expected to be used by a single thread at
+ * a time (Manager bus mutex).
+ */
+class NativeSerialBus : public Bus
+{
+public:
+  /**
+   * Open and configure given system serial
+   * port at given baudrate.
+   * isLowLatency: set the ASYNC_LOW_LATENCY flag.
+   * latencyTimer: FTDI latency timer in milliseconds
+   * (0 keeps the current setting).
+   * isDrain: flush() waits for all bytes
+   * to be physically transmitted (tcdrain).
+   * Throw std::runtime_error on failure.
+   */
+  NativeSerialBus(const std::string& port, unsigned int baudrate, bool isLowLatency = true,
+                  unsigned int latencyTimer = 1, bool isDrain = false);
+
+  /**
+   * Close the port
+   */
+  virtual ~NativeSerialBus();
+
+  bool sendData(uint8_t* data, size_t size);
+  bool sendDataV(const struct iovec* iov, size_t count);
+  bool waitForData(double timeout);
+  size_t available();
+  size_t readData(uint8_t* data, size_t size);
+  void flush();
+  void clearInputBuffer();
+  void retryOpening();
+
+private:
+  /**
+   * Port configuration
+   */
+  std::string _port;
+  unsigned int _baudrate;
+  bool _isLowLatency;
+  unsigned int _latencyTimer;
+  bool _isDrain;
+
+  /**
+   * Port file descriptor
+   */
+  int _fd;
+
+  /**
+   * Copy of the sendDataV() buffers vector
+   * advanced on partial writes
+   */
+  std::vector<struct iovec> _iov;
+
+  /**
+   * Wait for the output queue to accept
+   * more bytes. Return false on timeout.
+   */
+  bool waitWritable();
+
+  /**
+   * Open and configure the port.
+   * Throw std::runtime_error on failure.
+   */
+  void open();
+
+  /**
+   * Close the port if opened
+   */
+  void close();
+
+  /**
+   * Best effort low latency configuration.
+   * Unsupported settings (PTY, non FTDI
+   * adapters) are silently ignored.
+   */
+  void setupLowLatency();
+};
+}  // namespace RhAL
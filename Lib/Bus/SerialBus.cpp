@@ -63,6 +63,24 @@ bool SerialBus::sendData(uint8_t* data, size_t size)
   return false;
 }
 
+bool SerialBus::sendDataV(const struct iovec* iov, size_t count)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  buffer.clear();
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint8_t* data = static_cast<const uint8_t*>(iov[i].iov_base);
+    buffer.insert(buffer.end(), data, data + iov[i].iov_len);
+  }
+  try
+  {
+    return serial.write(buffer.data(), buffer.size()) == buffer.size();
+  }
+  SERIAL_CATCH(sendDataV)
+
+  return false;
+}
+
 bool SerialBus::waitForData(double timeout)
 {
   std::lock_guard<std::mutex> lock(mutex);
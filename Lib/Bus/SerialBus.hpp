@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <serial/serial.h>
 #include <mutex>
 #include "Bus.hpp"
@@ -13,6 +14,7 @@ public:
   SerialBus(std::string port, unsigned int baudrate);
 
   bool sendData(uint8_t* data, size_t size);
+  bool sendDataV(const struct iovec* iov, size_t count);
   bool waitForData(double timeout);
   size_t available();
   size_t readData(uint8_t* data, size_t size);
@@ -23,5 +25,12 @@ public:
 protected:
   serial::Serial serial;
   std::mutex mutex;
+
+  /**
+   * Gathered buffers reused between
+   * sendDataV() calls (the serial library
+   * only writes contiguous data)
+   */
+  std::vector<uint8_t> buffer;
 };
 }  // namespace RhAL
@@ -70,6 +70,8 @@ ExampleDevice1::ExampleDevice1(const std::string& name, id_t id)
   , _zero("zero", 0.0)
   , _mutex()
 {
+  _position.setPriority(PriorityHigh);
+  _temperature.setPriority(PriorityLow);
 }
 
 TypedRegisterFloat& ExampleDevice1::goal()
@@ -82,7 +84,7 @@ TypedRegisterFloat& ExampleDevice1::position()
 }
 TypedRegisterFloat& ExampleDevice1::temperature()
 {
-  return _position;
+  return _temperature;
 }
 
 float ExampleDevice1::getInverted() const
@@ -223,6 +223,7 @@ MX::MX(const std::string& name, id_t id)
   _position.setMinValue(-180.0);
   _position.setMaxValue(180.0 - 0.087890625);
   _position.setStepValue(0.087890625);
+  _position.setPriority(PriorityHigh);
 
   _speed.setMinValue(-702.42);
   _speed.setMaxValue(702.42);
@@ -286,11 +286,15 @@ RX::RX(const std::string& name, id_t id)
   _position.setMinValue(-150.0);
   _position.setMaxValue(150.0 - 0.29296875);
   _position.setStepValue(0.29296875);
+  _position.setPriority(PriorityHigh);
 
   _speed.setMinValue(-702.42);
   _speed.setMaxValue(702.42);
   _speed.setStepValue(0.68662);
 
+  _voltage.setPriority(PriorityLow);
+  _temperature.setPriority(PriorityLow);
+
   _punch.setMinValue(32);
   _punch.setMaxValue(1023);
   _punch.setStepValue(1);
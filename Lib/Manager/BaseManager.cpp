@@ -1,4 +1,16 @@
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <limits>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "BaseManager.hpp"
 
 namespace RhAL
@@ -10,7 +22,23 @@ BaseManager::BaseManager()
   , _parametersList()
   , _mutexBus()
   , _sortedRegisters()
+  , _sortedDevices()
+  , _periodicSchedule()
+  , _sortedPhases()
+  , _periodicLoad()
+  , _isScheduleOutdated(false)
+  , _isScheduleStaggered(true)
+  , _subscriptions()
+  , _subscribedFrequencies()
+  , _isSubscriptionOutdated(false)
+  , _isSubscribedReadsOnly(false)
+  , _measuredFlushPeriod(-1.0)
+  , _planIndexes()
+  , _swapIndexes()
   , _readCycleCount(0)
+  , _planCacheRead()
+  , _planCacheWrite()
+  , _planSelection()
   , _managerWaitUser1()
   , _managerWaitUser2()
   , _userWaitManager1()
@@ -23,14 +51,57 @@ BaseManager::BaseManager()
   , _currentThreadCooperativeWaiting1(0)
   , _currentThreadCooperativeWaiting2(0)
   , _stats()
-  , _bus(nullptr)
-  , _protocol(nullptr)
+  , _lines()
+  , _flushPlanRead(nullptr)
+  , _flushPlanWrite(nullptr)
+  , _flushBudget(0.0)
+  , _flushAging(1)
+  , _flushStart()
   , _paramBusPort("port", "")
   , _paramBusBaudrate("baudrate", 1000000)
+  , _paramBusName("bus", "SerialBus")
+  , _paramBusLowLatency("busLowLatency", true)
+  , _paramBusLatencyTimer("busLatencyTimer", 1)
+  , _paramBusDrain("busDrain", false)
+  , _paramBusExtraPorts("extraPorts", "")
   , _paramProtocolName("protocol", "FakeProtocol")
   , _paramEnableSyncRead("enableSyncRead", true)
   , _paramEnableSyncWrite("enableSyncWrite", true)
+  , _paramEnableGapRead("enableGapRead", false)
+  , _paramPacketOverhead("packetOverhead", 0.0005)
+  , _paramEnableBulkRead("enableBulkRead", false)
+  , _paramEnableBulkWrite("enableBulkWrite", false)
+  , _paramQuarantineFailures("quarantineFailures", 0)
+  , _paramQuarantineMaxBackoff("quarantineMaxBackoff", 64)
+  , _quarantinedDevices()
+  , _paramSlowWriteProbe("slowWriteProbe", false)
+  , _busyDevices()
+  , _paramForceCoalesceWindow("forceCoalesceWindow", 0.0)
+  , _forceGroups()
+  , _mutexForce()
+  , _forceGroupDone()
+  , _forceGroupJoin()
+  , _forceCallerCount(0)
+  , _forceGroupedCount(0)
+  , _deviceGroups()
+  , _snapshotIds()
+  , _snapshotNames()
+  , _snapshotRegisters()
+  , _snapshotPool()
+  , _snapshot()
+  , _backgroundReads()
+  , _backgroundNext(0)
+  , _paramBackgroundReadMargin("backgroundReadMargin", 0.0005)
+  , _paramStaggerPeriodicReads("staggerPeriodicReads", true)
+  , _paramSubscribedReadsOnly("subscribedReadsOnly", false)
+  , _paramSchedulerFrequency("schedulerFrequency", 0.0)
+  , _paramSchedulerPriority("schedulerPriority", 0)
+  , _paramSchedulerCpu("schedulerCpu", -1)
+  , _paramSchedulerLockMemory("schedulerLockMemory", false)
+  , _paramFlushBudget("flushBudget", 0.0)
+  , _paramFlushBudgetAging("flushBudgetAging", 4)
   , _paramWaitWriteCheckResponse("waitWriteCheckResponse", false)
+  , _paramPipelineWrites("pipelineWrites", false)
   , _paramThrowErrorOnScan("throwErrorOnScan", true)
   , _paramThrowErrorOnRead("throwErrorOnRead", true)
 {
@@ -38,10 +109,33 @@ BaseManager::BaseManager()
   _parametersList.add(&this->_paramScheduleMode);
   _parametersList.add(&_paramBusPort);
   _parametersList.add(&_paramBusBaudrate);
+  _parametersList.add(&_paramBusName);
+  _parametersList.add(&_paramBusLowLatency);
+  _parametersList.add(&_paramBusLatencyTimer);
+  _parametersList.add(&_paramBusDrain);
+  _parametersList.add(&_paramBusExtraPorts);
   _parametersList.add(&_paramProtocolName);
   _parametersList.add(&_paramEnableSyncRead);
   _parametersList.add(&_paramEnableSyncWrite);
+  _parametersList.add(&_paramEnableGapRead);
+  _parametersList.add(&_paramPacketOverhead);
+  _parametersList.add(&_paramEnableBulkRead);
+  _parametersList.add(&_paramEnableBulkWrite);
+  _parametersList.add(&_paramQuarantineFailures);
+  _parametersList.add(&_paramQuarantineMaxBackoff);
+  _parametersList.add(&_paramSlowWriteProbe);
+  _parametersList.add(&_paramBackgroundReadMargin);
+  _parametersList.add(&_paramForceCoalesceWindow);
+  _parametersList.add(&_paramStaggerPeriodicReads);
+  _parametersList.add(&_paramSubscribedReadsOnly);
+  _parametersList.add(&_paramSchedulerFrequency);
+  _parametersList.add(&_paramSchedulerPriority);
+  _parametersList.add(&_paramSchedulerCpu);
+  _parametersList.add(&_paramSchedulerLockMemory);
+  _parametersList.add(&_paramFlushBudget);
+  _parametersList.add(&_paramFlushBudgetAging);
   _parametersList.add(&_paramWaitWriteCheckResponse);
+  _parametersList.add(&_paramPipelineWrites);
   _parametersList.add(&_paramThrowErrorOnScan);
   _parametersList.add(&_paramThrowErrorOnRead);
   // Initialize the low level communication
@@ -50,16 +144,7 @@ BaseManager::BaseManager()
 
 BaseManager::~BaseManager()
 {
-  if (_protocol != nullptr)
-  {
-    delete _protocol;
-    _protocol = nullptr;
-  }
-  if (_bus != nullptr)
-  {
-    delete _bus;
-    _bus = nullptr;
-  }
+  closeBuses();
 }
 
 const Device& BaseManager::dev(id_t id) const
@@ -169,27 +254,43 @@ void BaseManager::disableCooperativeThread()
 void BaseManager::emergencyStop()
 {
   // Check for bus inited
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   _stats.emergencyCount++;
-  _protocol->emergencyStop();
+  // Stop the Devices of all buses
+  std::vector<id_t> ids;
+  std::vector<addr_t> addresses;
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    torqueEnableAddresses(i, ids, addresses);
+    // Stop commands are never queued
+    ImmediateTransfer transfer(*_lines[i]);
+    _lines[i]->protocol->emergencyStop(ids, addresses);
+  }
 }
 
 void BaseManager::exitEmergencyState()
 {
   // Check for inited
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   _stats.exitEmergencyCount++;
-  _protocol->exitEmergencyState();
+  std::vector<id_t> ids;
+  std::vector<addr_t> addresses;
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    torqueEnableAddresses(i, ids, addresses);
+    ImmediateTransfer transfer(*_lines[i]);
+    _lines[i]->protocol->exitEmergencyState(ids, addresses);
+  }
 }
 
 void BaseManager::waitNextFlush()
@@ -300,7 +401,7 @@ void BaseManager::waitNextFlush()
   lock.unlock();
 }
 
-void BaseManager::flush(bool isForceSwap)
+void BaseManager::flush(bool isForceSwap, double budget)
 {
   // No cooperative thread if
   // scheduling mode is disabled
@@ -358,6 +459,15 @@ void BaseManager::flush(bool isForceSwap)
       _stats.maxFlushPeriod = d;
     }
     _stats.sumFlushPeriod += d;
+    if (_measuredFlushPeriod < 0.0)
+    {
+      _measuredFlushPeriod = duration_float(d);
+      _isSubscriptionOutdated = true;
+    }
+    else
+    {
+      _measuredFlushPeriod = 0.95 * _measuredFlushPeriod + 0.05 * duration_float(d);
+    }
   }
   _stats.lastFlushTimePoint = pStart;
   // Wait for all user thread to have reach the
@@ -377,8 +487,16 @@ void BaseManager::flush(bool isForceSwap)
   swapCallBack();
   // Select registers for read and write
   // and compute operation batching
-  std::vector<BatchedRegisters> batchsRead = computeBatchedRegisters(true);
-  std::vector<BatchedRegisters> batchsWrite = computeBatchedRegisters(false);
+  BatchPlan& planRead = computeBatchedRegisters(true);
+  BatchPlan& planWrite = computeBatchedRegisters(false);
+  std::vector<BatchedRegisters>& batchsWrite = planWrite.batches;
+  // Retrieve the flush time budget
+  if (budget < 0.0)
+  {
+    budget = _paramFlushBudget.value;
+  }
+  unsigned int aging = (unsigned int)std::max(_paramFlushBudgetAging.value, 1.0);
+  bool isPipelined = _paramPipelineWrites.value;
 
   // Wait for all user thread to have reach the
   // second barrier
@@ -400,37 +518,61 @@ void BaseManager::flush(bool isForceSwap)
   _userWaitManager2.notify_all();
   // Unlock the shared mutex
   lock.unlock();
-
-  // Perform write operation on all batchs
-  bool needsToWait = false;
-  for (size_t i = 0; i < batchsWrite.size(); i++)
-  {
-    writeBatch(batchsWrite[i]);
-    // Check if a written register is slow
-    for (size_t j = 0; j < batchsWrite[i].regs.size(); j++)
+  // Bus operations start
+  TimePoint pBus = getTimePoint();
+  _flushPlanRead = &planRead;
+  _flushPlanWrite = &planWrite;
+  _flushBudget = budget;
+  _flushAging = aging;
+  _flushStart = pBus;
+
+  // Queued writes leave the Protocol
+  // ahead of the first read request
+  pipelineBuses(isPipelined);
+  try
+  {
+    // Perform write operation on all batchs
+    // (or on all bulks) and Device groups of each bus
+    runBusTasks(TaskWrite);
+
+    // Devices with a written slow register
+    // are excluded from the bus during their
+    // write window while others keep going
     {
-      for (size_t k = 0; k < batchsWrite[i].regs[j].size(); k++)
+      std::lock_guard<std::mutex> lockBus(_mutexBus);
+      for (size_t i = 0; i < batchsWrite.size(); i++)
       {
-        if (batchsWrite[i].regs[j][k]->isSlowRegister)
+        for (size_t j = 0; j < batchsWrite[i].regs.size(); j++)
         {
-          needsToWait = true;
+          for (size_t k = 0; k < batchsWrite[i].regs[j].size(); k++)
+          {
+            if (batchsWrite[i].regs[j][k]->isSlowRegister)
+            {
+              beginSlowWrite(_devicesById.at(batchsWrite[i].ids[j]));
+              break;
+            }
+          }
         }
       }
     }
-  }
 
-  // If a slow register was written, we need
-  // to wait a big amount of time
-  if (needsToWait)
-  {
-    std::this_thread::sleep_for(std::chrono::milliseconds(SlowRegisterDelayMs));
-  }
+    // Readmit Devices at the end of
+    // their slow write window
+    releaseBusy();
+    // Try to readmit unresponsive Devices
+    probeQuarantined();
 
-  // Perform read operation on all batchs
-  for (size_t i = 0; i < batchsRead.size(); i++)
+    // Perform read operation on all batchs
+    // (or on all bulks) of each bus within
+    // the time budget
+    runBusTasks(TaskRead);
+  }
+  catch (...)
   {
-    readBatch(batchsRead[i]);
+    pipelineBuses(false);
+    throw;
   }
+  pipelineBuses(false);
 
   // Increment Read counter
   _readCycleCount++;
@@ -464,11 +606,14 @@ bool BaseManager::ping(id_t id)
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
-  bool response = _protocol->ping(id);
+  // Unknown ids are pinged on the main bus
+  BusLine& line = _devicesById.count(id) == 1 ? busLine(_devicesById.at(id)) : *_lines.front();
+  ImmediateTransfer transfer(line);
+  bool response = line.protocol->ping(id);
   if (_devicesById.count(id) == 1)
   {
     // If the device is register,
@@ -486,11 +631,13 @@ void BaseManager::changeDeviceId(id_t oldId, id_t newId)
   }
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
+  BusLine& line = _devicesById.count(oldId) == 1 ? busLine(_devicesById.at(oldId)) : *_lines.front();
+  ImmediateTransfer transfer(line);
   // Write to standard id register at address 3
   uint8_t data = newId;
   if (_paramWaitWriteCheckResponse.value)
   {
-    ResponseState state = _protocol->writeAndCheckData(oldId, 0x03, &data, 1);
+    ResponseState state = line.protocol->writeAndCheckData(oldId, 0x03, &data, 1);
     if (checkResponseState(state, nullptr))
     {
       std::cerr << "Changing Device id from " << oldId << " to " << newId << std::endl;
@@ -505,7 +652,7 @@ void BaseManager::changeDeviceId(id_t oldId, id_t newId)
   }
   else
   {
-    _protocol->writeData(oldId, 0x03, &data, 1);
+    line.protocol->writeData(oldId, 0x03, &data, 1);
     std::cerr << "Changing Device id from " << oldId << " to " << newId << std::endl;
     // Sucessfully stop the processus
     exit(0);
@@ -517,7 +664,7 @@ void BaseManager::scan()
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
@@ -526,60 +673,65 @@ void BaseManager::scan()
   {
     it.second->setPresent(false);
   }
-  // Iterate over all possible Id
-  for (id_t i = IdDevBegin; i <= IdDevEnd; i++)
+  // Iterate over all buses and possible Id
+  for (size_t bus = 0; bus < _lines.size(); bus++)
   {
-    // If the Device exist on the bus
-    if (_protocol->ping(i))
+    ImmediateTransfer transfer(*_lines[bus]);
+    for (id_t i = IdDevBegin; i <= IdDevEnd; i++)
     {
-      // Retrieve the model number
-      type_t type;
-      bool isSuccess = retrieveTypeNumber(i, type);
-      // Skip the Device if model number
-      // can not be retrieved
-      if (!isSuccess)
-      {
-        continue;
-      }
-      // Check if the Device is already known
-      bool isExist = devExistsById(i);
-      if (isExist && this->devTypeNumberById(i) != type)
-      {
-        // Throw exception if scanned Device id
-        // is already known with a different type
-        throw std::logic_error("BaseManager scan type mismatch: " + std::string("id=") + std::to_string(i) +
-                               std::string(" type=") + std::to_string(type) + std::string(" is alreay known as ") +
-                               devById(i).name() + std::string(" with type ") + devTypeNameById(i));
-      }
-      else if (isExist)
+      // If the Device exist on the bus
+      if (_lines[bus]->protocol->ping(i))
       {
-        // If no type problem mark
-        // the Device as present
-        devById(i).setPresent(true);
-      }
-      else
-      {
-        // Check if the type number is supported
-        // by the manager
-        if (!this->isTypeSupported(type))
+        // Retrieve the model number
+        type_t type;
+        bool isSuccess = retrieveTypeNumber(bus, i, type);
+        // Skip the Device if model number
+        // can not be retrieved
+        if (!isSuccess)
         {
-          // The type is not supported
-          if (_paramThrowErrorOnScan.value)
-          {
-            throw std::runtime_error("BaseManager type found in scan() not supported: " + std::to_string(type));
-          }
-          else
+          continue;
+        }
+        // Check if the Device is already known
+        bool isExist = devExistsById(i);
+        if (isExist && this->devTypeNumberById(i) != type)
+        {
+          // Throw exception if scanned Device id
+          // is already known with a different type
+          throw std::logic_error("BaseManager scan type mismatch: " + std::string("id=") + std::to_string(i) +
+                                 std::string(" type=") + std::to_string(type) + std::string(" is alreay known as ") +
+                                 devById(i).name() + std::string(" with type ") + devTypeNameById(i));
+        }
+        else if (isExist)
+        {
+          // If no type problem mark
+          // the Device as present
+          devById(i).setPresent(true);
+        }
+        else
+        {
+          // Check if the type number is supported
+          // by the manager
+          if (!this->isTypeSupported(type))
           {
-            std::cerr << "BaseManager type found in scan() not supported: "
-                      << "id=" << i << " type=" << std::to_string(type) << std::endl;
-            continue;
+            // The type is not supported
+            if (_paramThrowErrorOnScan.value)
+            {
+              throw std::runtime_error("BaseManager type found in scan() not supported: " + std::to_string(type));
+            }
+            else
+            {
+              std::cerr << "BaseManager type found in scan() not supported: "
+                        << "id=" << i << " type=" << std::to_string(type) << std::endl;
+              continue;
+            }
           }
+          // The Device is not yet present,
+          // it is created on the scanned bus
+          this->devAddByTypeNumber(i, type);
+          devById(i)._bus.value = bus;
+          // Set it as present
+          devById(i).setPresent(true);
         }
-        // The Device is not yet present,
-        // it is created
-        this->devAddByTypeNumber(i, type);
-        // Set it as present
-        devById(i).setPresent(true);
       }
     }
   }
@@ -590,7 +742,7 @@ bool BaseManager::checkDevices()
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
@@ -598,7 +750,9 @@ bool BaseManager::checkDevices()
   bool isMissing = false;
   for (auto& dev : _devicesById)
   {
-    bool response = _protocol->ping(dev.first);
+    BusLine& line = busLine(dev.second);
+    ImmediateTransfer transfer(line);
+    bool response = line.protocol->ping(dev.first);
     if (!response)
     {
       isMissing = true;
@@ -640,16 +794,68 @@ void BaseManager::onNewRegister(id_t id, const std::string& name)
       return pt1->id < pt2->id;
     }
   });
+  // Update Registers indexes and Devices.
+  // The periodic reads schedule is rebuilt
+  // at next read cycle.
+  _sortedDevices.clear();
+  for (size_t i = 0; i < _sortedRegisters.size(); i++)
+  {
+    Register* reg = _sortedRegisters[i];
+    reg->_managerIndex = i;
+    _sortedDevices.push_back(_devicesById.at(reg->id));
+  }
+  _sortedPhases.assign(_sortedRegisters.size(), 0);
+  _subscribedFrequencies.assign(_sortedRegisters.size(), 0.0);
+  _isScheduleOutdated = true;
+  _isSubscriptionOutdated = true;
+  // Rebuild dirty sets from Registers flags
+  _dirtyRead.resize(_sortedRegisters.size());
+  _dirtyWrite.resize(_sortedRegisters.size());
+  _dirtySwap.resize(_sortedRegisters.size());
+  for (size_t i = 0; i < _sortedRegisters.size(); i++)
+  {
+    if (_sortedRegisters[i]->needRead())
+    {
+      _dirtyRead.insert(i);
+    }
+    if (_sortedRegisters[i]->needWrite())
+    {
+      _dirtyWrite.insert(i);
+    }
+    if (_sortedRegisters[i]->_needSwaping)
+    {
+      _dirtySwap.insert(i);
+    }
+  }
+  _planIndexes.reserve(_sortedRegisters.size());
+  _swapIndexes.reserve(_sortedRegisters.size());
+}
+
+bool BaseManager::isDeviceDontRead(id_t id)
+{
+  return devById(id).dontRead();
 }
 
 void BaseManager::forceRegisterRead(id_t id, const std::string& name)
 {
+  // Wait for the end of a slow
+  // register write on the Device
+  waitDeviceReady(&devById(id));
+  // Try to merge with concurrent
+  // reads of other Devices. The call
+  // is counted in flight only once
+  // ready to be issued.
+  ForceCaller caller(*this);
+  if (forceCoalesce(&(devById(id).registersList().reg(name)), false))
+  {
+    return;
+  }
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   _stats.regReadPerFlushAccu++;
   _stats.forceReadCount++;
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
@@ -661,6 +867,8 @@ void BaseManager::forceRegisterRead(id_t id, const std::string& name)
   {
     return;
   }
+  BusLine& line = busLine(device);
+  ImmediateTransfer transfer(line);
   // Reset read flags
   reg->readyForRead();
   // Read single register
@@ -672,7 +880,7 @@ void BaseManager::forceRegisterRead(id_t id, const std::string& name)
   while (true)
   {
     TimePoint pStart = getTimePoint();
-    ResponseState state = _protocol->readData(reg->id, reg->addr, reg->_dataBufferRead, reg->length);
+    ResponseState state = line.protocol->readData(reg->id, reg->addr, reg->_dataBufferRead, reg->length);
     TimePoint pStop = getTimePoint();
     _stats.readCount++;
     _stats.readLength += reg->length;
@@ -718,17 +926,31 @@ void BaseManager::forceRegisterRead(id_t id, const std::string& name)
 }
 void BaseManager::forceRegisterWrite(id_t id, const std::string& name)
 {
+  // Wait for the end of a slow
+  // register write on the Device
+  waitDeviceReady(&devById(id));
+  // Try to merge with concurrent
+  // writes of other Devices. The call
+  // is counted in flight only once
+  // ready to be issued.
+  ForceCaller caller(*this);
+  if (forceCoalesce(&(devById(id).registersList().reg(name)), true))
+  {
+    return;
+  }
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
   _stats.regWrittenPerFlushAccu++;
   _stats.forceWriteCount++;
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
   // Retrieve Register pointer
   Register* reg = &(devById(id).registersList().reg(name));
+  BusLine& line = busLine(&(devById(id)));
+  ImmediateTransfer transfer(line);
   // Export typed value into data buffer
   reg->selectForWrite();
   // Write the register
@@ -740,7 +962,7 @@ void BaseManager::forceRegisterWrite(id_t id, const std::string& name)
     if (_paramWaitWriteCheckResponse.value)
     {
       // Write and check response state
-      ResponseState state = _protocol->writeAndCheckData(reg->id, reg->addr, reg->_dataBufferWrite, reg->length);
+      ResponseState state = line.protocol->writeAndCheckData(reg->id, reg->addr, reg->_dataBufferWrite, reg->length);
       // Check for communication error
       if (checkResponseState(state, &(devById(id))))
       {
@@ -754,6 +976,7 @@ void BaseManager::forceRegisterWrite(id_t id, const std::string& name)
         if (nbFails >= MaxForceReTries)
         {
           reg->writeError();
+          reg->finishWrite(false);
           if (_paramThrowErrorOnRead.value)
           {
             throw std::runtime_error("BaseManager max tries reached when write error: " + reg->name +
@@ -771,7 +994,7 @@ void BaseManager::forceRegisterWrite(id_t id, const std::string& name)
     else
     {
       // Direct no write check case
-      _protocol->writeData(reg->id, reg->addr, reg->_dataBufferWrite, reg->length);
+      line.protocol->writeData(reg->id, reg->addr, reg->_dataBufferWrite, reg->length);
       isContinue = false;
     }
     TimePoint pStop = getTimePoint();
@@ -784,247 +1007,1487 @@ void BaseManager::forceRegisterWrite(id_t id, const std::string& name)
       _stats.maxWriteDuration = duration;
     }
   }
-  // Wait delay in case of slow register
+  // The Device is excluded from the bus
+  // in case of slow register
   if (reg->isSlowRegister)
   {
-    std::this_thread::sleep_for(std::chrono::milliseconds(SlowRegisterDelayMs));
+    beginSlowWrite(_devicesById.at(id));
   }
+  reg->finishWrite(true);
 }
 
-Statistics BaseManager::getStatistics() const
+bool BaseManager::forceCoalesce(Register* reg, bool isWrite)
 {
-  std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  return _stats;
-}
+  double window;
+  {
+    std::lock_guard<std::mutex> lock(CallManager::_mutex);
+    window = _paramForceCoalesceWindow.value;
+    // Coalesced requests are issued
+    // as sync operations
+    if ((!isWrite && !_paramEnableSyncRead.value) || (isWrite && !_paramEnableSyncWrite.value))
+    {
+      window = 0.0;
+    }
+  }
+  if (window <= 0.0)
+  {
+    return false;
+  }
+  // Only Devices of a same bus are coalesced
+  size_t bus = _devicesById.at(reg->id)->bus();
 
-void BaseManager::resetStatistics()
-{
-  std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _stats.reset();
-}
+  std::unique_lock<std::mutex> lock(_mutexForce);
+  // Join an open group with same operation
+  // if the Device is not already in
+  for (size_t i = 0; i < _forceGroups.size(); i++)
+  {
+    std::shared_ptr<ForceGroup> group = _forceGroups[i];
+    if (group->isWrite != isWrite || group->addr != reg->addr || group->length != reg->length || group->bus != bus)
+    {
+      continue;
+    }
+    for (size_t k = 0; k < group->regs.size(); k++)
+    {
+      if (group->regs[k]->id == reg->id)
+      {
+        return false;
+      }
+    }
+    size_t index = group->regs.size();
+    group->regs.push_back(reg);
+    group->isSuccess.push_back(false);
+    _forceGroupedCount++;
+    _forceGroupJoin.notify_all();
+    _forceGroupDone.wait(lock, [&group]() { return group->isFinished; });
+    _forceGroupedCount--;
+    _forceGroupJoin.notify_all();
+    return group->isSuccess[index];
+  }
 
-const ParametersList& BaseManager::parametersList() const
-{
-  return _parametersList;
-}
-ParametersList& BaseManager::parametersList()
-{
-  return _parametersList;
-}
+  // No wait if no other call could join
+  if (_forceCallerCount <= _forceGroupedCount + 1)
+  {
+    return false;
+  }
 
-const ParametersList& BaseManager::protocolParametersList() const
-{
-  // Check for initBus() called
-  if (_protocol == nullptr)
+  // Else open a new group and wait
+  // for concurrent requests until all
+  // other calls in flight are grouped
+  std::shared_ptr<ForceGroup> group = std::make_shared<ForceGroup>();
+  group->isWrite = isWrite;
+  group->addr = reg->addr;
+  group->length = reg->length;
+  group->bus = bus;
+  group->regs.push_back(reg);
+  group->isSuccess.push_back(false);
+  group->isFinished = false;
+  _forceGroups.push_back(group);
+  _forceGroupedCount++;
+  _forceGroupJoin.wait_for(lock, std::chrono::duration<double, std::micro>(window),
+                           [this]() { return _forceCallerCount <= _forceGroupedCount; });
+  _forceGroups.erase(std::find(_forceGroups.begin(), _forceGroups.end(), group));
+  lock.unlock();
+
+  // Perform the operation if at least one
+  // request has joined. Joined callers are
+  // always woken up.
+  try
   {
-    throw std::logic_error("BaseManager protocol not initialized");
+    if (group->regs.size() > 1)
+    {
+      forceGroupOperation(*group);
+    }
   }
-  return _protocol->parametersList();
+  catch (...)
+  {
+    lock.lock();
+    group->isFinished = true;
+    _forceGroupedCount--;
+    _forceGroupDone.notify_all();
+    _forceGroupJoin.notify_all();
+    throw;
+  }
+  lock.lock();
+  group->isFinished = true;
+  _forceGroupedCount--;
+  _forceGroupDone.notify_all();
+  _forceGroupJoin.notify_all();
+  return group->isSuccess[0];
 }
-ParametersList& BaseManager::protocolParametersList()
+
+void BaseManager::forceGroupOperation(ForceGroup& group)
 {
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
-  return _protocol->parametersList();
-}
+  std::vector<id_t> ids;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < group.regs.size(); i++)
+  {
+    Register* reg = group.regs[i];
+    // Nothing to read on dont read Devices
+    if (!group.isWrite && _devicesById.at(reg->id)->dontRead())
+    {
+      group.isSuccess[i] = true;
+      continue;
+    }
+    ids.push_back(reg->id);
+    indexes.push_back(i);
+  }
+  if (ids.size() == 0)
+  {
+    return;
+  }
+  BusLine& line = busLine(_devicesById.at(ids.front()));
+  ImmediateTransfer transfer(line);
+  std::vector<ResponseState> states(ids.size(), ResponseOK);
 
-void BaseManager::setProtocolConfig(const std::string& port, unsigned long baudrate, const std::string& protocol)
-{
-  std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramBusPort.value = port;
-  _paramBusBaudrate.value = baudrate;
-  _paramProtocolName.value = protocol;
-  // Reset low level communication (bus/protocol)
-  initBus();
+  if (!group.isWrite)
+  {
+    std::vector<data_t*> datas;
+    for (size_t i = 0; i < indexes.size(); i++)
+    {
+      group.regs[indexes[i]]->readyForRead();
+      datas.push_back(group.regs[indexes[i]]->_dataBufferRead);
+    }
+    TimePoint pStart = getTimePoint();
+    line.protocol->syncRead(ids, group.addr, datas, group.length, states);
+    TimePoint pStop = getTimePoint();
+    _stats.regReadPerFlushAccu += ids.size();
+    _stats.forceReadCount += ids.size();
+    _stats.forceCoalescedCount += ids.size();
+    _stats.syncReadCount++;
+    _stats.syncReadLength += group.length;
+    TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+    _stats.sumSyncReadDuration += duration;
+    if (_stats.maxSyncReadDuration < duration)
+    {
+      _stats.maxSyncReadDuration = duration;
+    }
+    TimePoint timestamp = averageTimePoints(pStart, pStop);
+    for (size_t i = 0; i < indexes.size(); i++)
+    {
+      Register* reg = group.regs[indexes[i]];
+      if (checkResponseState(states[i], _devicesById.at(ids[i])))
+      {
+        reg->finishRead(timestamp);
+        reg->swapRead();
+        group.isSuccess[indexes[i]] = true;
+      }
+      else
+      {
+        reg->readError();
+      }
+    }
+  }
+  else
+  {
+    std::vector<const data_t*> datas;
+    for (size_t i = 0; i < indexes.size(); i++)
+    {
+      group.regs[indexes[i]]->selectForWrite();
+      datas.push_back(group.regs[indexes[i]]->_dataBufferWrite);
+    }
+    TimePoint pStart = getTimePoint();
+    if (_paramWaitWriteCheckResponse.value)
+    {
+      line.protocol->syncWriteAndCheck(ids, group.addr, datas, group.length, states);
+    }
+    else
+    {
+      line.protocol->syncWrite(ids, group.addr, datas, group.length);
+    }
+    TimePoint pStop = getTimePoint();
+    _stats.regWrittenPerFlushAccu += ids.size();
+    _stats.forceWriteCount += ids.size();
+    _stats.forceCoalescedCount += ids.size();
+    _stats.syncWriteCount++;
+    _stats.syncWriteLength += group.length;
+    TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+    _stats.sumSyncWriteDuration += duration;
+    if (_stats.maxSyncWriteDuration < duration)
+    {
+      _stats.maxSyncWriteDuration = duration;
+    }
+    for (size_t i = 0; i < indexes.size(); i++)
+    {
+      Register* reg = group.regs[indexes[i]];
+      if (!_paramWaitWriteCheckResponse.value || checkResponseState(states[i], _devicesById.at(ids[i])))
+      {
+        // The Device is excluded from the
+        // bus in case of slow register
+        if (reg->isSlowRegister)
+        {
+          beginSlowWrite(_devicesById.at(ids[i]));
+        }
+        reg->finishWrite(true);
+        group.isSuccess[indexes[i]] = true;
+      }
+      else
+      {
+        _stats.writeErrorCount++;
+      }
+    }
+  }
 }
 
-void BaseManager::setEnableSyncRead(bool isEnable)
-{
-  std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramEnableSyncRead.value = isEnable;
-}
-void BaseManager::setEnableSyncWrite(bool isEnable)
+size_t BaseManager::subscribeRead(id_t id, const std::string& name, double frequency)
 {
+  if (!(frequency > 0.0))
+  {
+    throw std::logic_error("BaseManager subscribeRead invalid rate: " + std::to_string(frequency));
+  }
+  Register* reg = &(devById(id).registersList().reg(name));
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramEnableSyncWrite.value = isEnable;
+  _isSubscriptionOutdated = true;
+  // Reuse a cancelled
+  // subscription slot
+  for (size_t i = 0; i < _subscriptions.size(); i++)
+  {
+    if (!_subscriptions[i].isActive)
+    {
+      _subscriptions[i] = { reg, frequency, true };
+      return i;
+    }
+  }
+  _subscriptions.push_back({ reg, frequency, true });
+  return _subscriptions.size() - 1;
 }
-void BaseManager::setWaitWriteCheckResponse(bool isEnable)
+
+void BaseManager::unsubscribeRead(size_t handle)
 {
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramWaitWriteCheckResponse.value = isEnable;
+  if (handle >= _subscriptions.size() || !_subscriptions[handle].isActive)
+  {
+    throw std::logic_error("BaseManager unsubscribeRead invalid handle: " + std::to_string(handle));
+  }
+  _subscriptions[handle].isActive = false;
+  _isSubscriptionOutdated = true;
 }
-void BaseManager::setThrowOnScan(bool isEnable)
+
+void BaseManager::addBackgroundRead(id_t id, const std::string& name)
 {
+  Register* reg = &(devById(id).registersList().reg(name));
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramThrowErrorOnScan.value = isEnable;
+  if (std::find(_backgroundReads.begin(), _backgroundReads.end(), reg) == _backgroundReads.end())
+  {
+    _backgroundReads.push_back(reg);
+    reg->_isBackgroundRead = true;
+  }
 }
-void BaseManager::setThrowOnRead(bool isEnable)
+
+void BaseManager::removeBackgroundRead(id_t id, const std::string& name)
 {
+  Register* reg = &(devById(id).registersList().reg(name));
   std::lock_guard<std::mutex> lock(CallManager::_mutex);
-  _paramThrowErrorOnRead.value = isEnable;
+  std::vector<Register*>::iterator it = std::find(_backgroundReads.begin(), _backgroundReads.end(), reg);
+  if (it != _backgroundReads.end())
+  {
+    _backgroundReads.erase(it);
+    reg->_isBackgroundRead = false;
+  }
 }
 
-void BaseManager::initBus()
+DeviceGroup& BaseManager::addDeviceGroup(const std::vector<id_t>& ids, const std::string& name)
 {
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
   std::lock_guard<std::mutex> lockBus(_mutexBus);
-  // Free existing instance
-  if (_protocol != nullptr)
-  {
-    delete _protocol;
-    _protocol = nullptr;
-  }
-  if (_bus != nullptr)
+  std::vector<TypedRegisterFloat*> regs;
+  for (size_t i = 0; i < ids.size(); i++)
   {
-    delete _bus;
-    _bus = nullptr;
-  }
-  // Allocate Bus and Protocol
-  if (_paramBusPort.value != "")
-  {
-    try
+    TypedRegisterFloat* reg = dynamic_cast<TypedRegisterFloat*>(&(devById(ids[i]).registersList().reg(name)));
+    if (reg == nullptr)
     {
-      _bus = new SerialBus(_paramBusPort.value, _paramBusBaudrate.value);
+      throw std::logic_error("BaseManager device group register is not float: " + name);
     }
-    catch (const std::exception& e)
+    if (devById(ids[i]).bus() != devById(ids.front()).bus())
     {
-      throw std::runtime_error("SerialBus initialization failed:" + std::string(" port:") +
-                               std::string(_paramBusPort.value) + std::string(" exception: ") + std::string(e.what()));
+      throw std::logic_error("BaseManager device group devices on different buses: " + name);
     }
+    regs.push_back(reg);
   }
-  _protocol = ProtocolFactory(_paramProtocolName.value, *_bus);
-  // Check that Protocol implementation name is valid
-  if (_protocol == nullptr)
-  {
-    throw std::logic_error("BaseManager invalid protocol name: " + _paramProtocolName.value);
-  }
-}
-
-bool BaseManager::isNeedRead(Register* reg)
-{
-  Device* device = _devicesById.at(reg->id);
-
-  return (!device->dontRead()) &&
-         (reg->needRead() || (reg->periodPackedRead > 0 && (_readCycleCount % reg->periodPackedRead == 0)));
+  _deviceGroups.push_back(std::unique_ptr<DeviceGroup>(new DeviceGroup(ids, regs)));
+  return *_deviceGroups.back();
 }
 
-bool BaseManager::isNeedWrite(Register* reg)
+void BaseManager::writeDeviceGroups(size_t bus)
 {
-  bool isNeed = reg->needWrite();
-  // If selected for write, register
-  // is reset for write aggregation
-  if (isNeed)
+  std::unique_lock<std::mutex> lockBus(_mutexBus);
+  bool isParallel = _lines.size() > 1;
+  for (size_t k = 0; k < _deviceGroups.size(); k++)
   {
-    reg->selectForWrite();
-  }
-  return isNeed;
-}
-
-std::vector<BaseManager::BatchedRegisters> BaseManager::computeBatchedRegisters(bool isReadOrWrite)
-{
-  // Batched registers container
-  std::vector<BatchedRegisters> container;
-
-  // Merge the given temporary batch to
-  // final batches by merging by id
-  auto mergeById = [&container, isReadOrWrite, this](const BatchedRegisters& tmpBatch) {
-    // SyncRead/Write is enable whenether
-    // configuration boolean are set
-    bool isSyncEnable =
-        (isReadOrWrite && this->_paramEnableSyncRead.value) || (!isReadOrWrite && this->_paramEnableSyncWrite.value);
-    bool found = false;
-    // Already added final batch are iterated
-    // to find if the current batch can be merge
-    // with another batch by id with constant address
-    // and length.
-    for (size_t j = 0; j < container.size(); j++)
+    DeviceGroup& group = *_deviceGroups[k];
+    if (!group.needWrite() || _devicesById.at(group._ids.front())->bus() != bus)
+    {
+      continue;
+    }
+    // Check for initBus() called
+    if (_lines.size() == 0)
+    {
+      throw std::logic_error("BaseManager protocol not initialized");
+    }
+    // Take the last encoded values of the
+    // Devices on the bus. Values of excluded
+    // Devices are kept pending.
+    group._sendIds.clear();
+    group._sendDatas.clear();
     {
-      if (isSyncEnable && container[j].addr == tmpBatch.addr && container[j].length == tmpBatch.length)
+      std::lock_guard<std::mutex> lock(group._mutex);
+      bool isPending = false;
+      for (size_t i = 0; i < group._ids.size(); i++)
       {
-        container[j].regs.push_back(std::vector<Register*>());
-        container[j].ids.push_back(tmpBatch.ids.front());
-        for (size_t k = 0; k < tmpBatch.regs.front().size(); k++)
+        if (!group._isPending[i])
+        {
+          continue;
+        }
+        Device* device = _devicesById.at(group._ids[i]);
+        if (device->isQuarantined() || device->isBusy())
         {
-          container[j].regs.back().push_back(tmpBatch.regs.front()[k]);
+          isPending = true;
+          continue;
         }
-        found = true;
-        break;
+        std::memcpy(group._bufferSend.data() + i * group._length, group._buffer.data() + i * group._length,
+                    group._length);
+        group._isPending[i] = false;
+        group._sendIds.push_back(group._ids[i]);
+        group._sendDatas.push_back(group._bufferSend.data() + i * group._length);
       }
+      group._needWrite = isPending;
     }
-    // If no compatible final batch are
-    // found a new one is created
-    if (!found)
+    if (group._sendIds.size() == 0)
     {
-      container.push_back(tmpBatch);
+      continue;
     }
-  };
 
-  // Iterate over all sorted Registers
-  // by id and then by address
-  BatchedRegisters tmpBatch;
-  for (size_t i = 0; i < _sortedRegisters.size(); i++)
-  {
-    Register* reg = _sortedRegisters[i];
-    // Select batched registers according to
-    // the given predicate function
-    if ((isReadOrWrite && isNeedRead(reg)) || (!isReadOrWrite && isNeedWrite(reg)))
+    BusLine& line = busLine(_devicesById.at(group._sendIds.front()));
+    group._sendStates.assign(group._sendIds.size(), ResponseOK);
+    _stats.regWrittenPerFlushAccu += group._sendIds.size();
+    _stats.deviceGroupWriteCount++;
+    if (_paramEnableSyncWrite.value)
     {
-      // Initialize the temporary batch if empty
-      if (tmpBatch.regs.size() == 0)
+      // Synch Write all Devices
+      TimePoint pStart = getTimePoint();
+      if (_paramWaitWriteCheckResponse.value)
       {
-        tmpBatch.addr = reg->addr;
-        tmpBatch.length = reg->length;
-        tmpBatch.regs = { { reg } };
-        tmpBatch.ids = { reg->id };
-        // And continue to next register
-        continue;
+        // Write and check response state
+        BusTransfer transfer(lockBus, line.mutex, isParallel);
+        line.protocol->syncWriteAndCheck(group._sendIds, group._addr, group._sendDatas, group._length,
+                                         group._sendStates);
       }
-      bool isContigious = (tmpBatch.addr + tmpBatch.length == reg->addr) && (reg->id == tmpBatch.ids.front());
-      if (isContigious)
+      else
       {
-        // If the register is contigious to current
-        // batch, it is added to it.
-        // Registers are first batched by address
-        // with id constant.
-        tmpBatch.length += reg->length;
-        tmpBatch.regs.front().push_back(reg);
+        // Direct write no check case
+        BusTransfer transfer(lockBus, line.mutex, isParallel);
+        line.protocol->syncWrite(group._sendIds, group._addr, group._sendDatas, group._length);
       }
-      else
+      TimePoint pStop = getTimePoint();
+      _stats.syncWriteCount++;
+      _stats.syncWriteLength += group._length;
+      TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+      _stats.sumSyncWriteDuration += duration;
+      if (_stats.maxSyncWriteDuration < duration)
       {
-        // If the register is not contiguous,
-        // the temporaty batch is added to
-        // the final container.
-        mergeById(tmpBatch);
-        // Reset the temporary batch
-        tmpBatch.regs.clear();
-        tmpBatch.ids.clear();
-        // And a new temporary batch is initialize
-        tmpBatch.addr = reg->addr;
-        tmpBatch.length = reg->length;
-        tmpBatch.regs = { { reg } };
-        tmpBatch.ids = { reg->id };
+        _stats.maxSyncWriteDuration = duration;
       }
     }
+    else
+    {
+      // Write each Device
+      for (size_t i = 0; i < group._sendIds.size(); i++)
+      {
+        TimePoint pStart = getTimePoint();
+        if (_paramWaitWriteCheckResponse.value)
+        {
+          // Write and check response state
+          BusTransfer transfer(lockBus, line.mutex, isParallel);
+          group._sendStates[i] = line.protocol->writeAndCheckData(group._sendIds[i], group._addr,
+                                                                  group._sendDatas[i], group._length);
+        }
+        else
+        {
+          // Direct write no check case
+          BusTransfer transfer(lockBus, line.mutex, isParallel);
+          line.protocol->writeData(group._sendIds[i], group._addr, group._sendDatas[i], group._length);
+        }
+        TimePoint pStop = getTimePoint();
+        _stats.writeCount++;
+        _stats.writeLength += group._length;
+        TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+        _stats.sumWriteDuration += duration;
+        if (_stats.maxWriteDuration < duration)
+        {
+          _stats.maxWriteDuration = duration;
+        }
+      }
+    }
+    // On error, the Device value is sent
+    // again at next flush unless replaced
+    if (_paramWaitWriteCheckResponse.value)
+    {
+      for (size_t i = 0; i < group._sendIds.size(); i++)
+      {
+        if (!checkResponseState(group._sendStates[i], _devicesById.at(group._sendIds[i])))
+        {
+          _stats.writeErrorCount++;
+          size_t index = (group._sendDatas[i] - group._bufferSend.data()) / group._length;
+          std::lock_guard<std::mutex> lock(group._mutex);
+          group._isPending[index] = true;
+          group._needWrite = true;
+        }
+      }
+    }
+    // The Devices are excluded from the
+    // bus in case of slow register
+    if (group._regs.front()->isSlowRegister)
+    {
+      for (size_t i = 0; i < group._sendIds.size(); i++)
+      {
+        beginSlowWrite(_devicesById.at(group._sendIds[i]));
+      }
+    }
+  }
+}
+
+void BaseManager::setSnapshotRegisters(const std::vector<std::string>& names)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  std::vector<id_t> ids;
+  std::vector<TypedRegisterFloat*> regs;
+  for (auto& it : _devicesById)
+  {
+    ids.push_back(it.first);
+  }
+  for (size_t k = 0; k < names.size(); k++)
+  {
+    for (auto& it : _devicesById)
+    {
+      TypedRegisterFloat* reg = nullptr;
+      if (it.second->registersList().exists(names[k]))
+      {
+        reg = dynamic_cast<TypedRegisterFloat*>(&(it.second->registersList().reg(names[k])));
+        if (reg == nullptr)
+        {
+          throw std::logic_error("BaseManager snapshot register is not float: " + names[k]);
+        }
+      }
+      regs.push_back(reg);
+    }
+  }
+  _snapshotIds = ids;
+  _snapshotNames = names;
+  _snapshotRegisters = regs;
+  publishSnapshot();
+}
+
+std::shared_ptr<const StateSnapshot> BaseManager::snapshot() const
+{
+  return std::atomic_load(&_snapshot);
+}
+
+Statistics BaseManager::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  Statistics stats = _stats;
+  stats.periodicReadLoad = _periodicLoad;
+  return stats;
+}
+
+void BaseManager::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _stats.reset();
+}
+
+const ParametersList& BaseManager::parametersList() const
+{
+  return _parametersList;
+}
+ParametersList& BaseManager::parametersList()
+{
+  return _parametersList;
+}
+
+const ParametersList& BaseManager::protocolParametersList() const
+{
+  return protocolParametersList(0);
+}
+ParametersList& BaseManager::protocolParametersList()
+{
+  return protocolParametersList(0);
+}
+const ParametersList& BaseManager::protocolParametersList(size_t bus) const
+{
+  // Check for initBus() called
+  if (bus >= _lines.size())
+  {
+    throw std::logic_error("BaseManager protocol not initialized");
+  }
+  return _lines[bus]->protocol->parametersList();
+}
+ParametersList& BaseManager::protocolParametersList(size_t bus)
+{
+  // Check for initBus() called
+  if (bus >= _lines.size())
+  {
+    throw std::logic_error("BaseManager protocol not initialized");
+  }
+  return _lines[bus]->protocol->parametersList();
+}
+
+size_t BaseManager::busCount() const
+{
+  return _lines.size();
+}
+
+void BaseManager::setProtocolConfig(const std::string& port, unsigned long baudrate, const std::string& protocol)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramBusPort.value = port;
+  _paramBusBaudrate.value = baudrate;
+  _paramProtocolName.value = protocol;
+  // Reset low level communication (bus/protocol)
+  initBus();
+}
+
+void BaseManager::setEnableSyncRead(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramEnableSyncRead.value = isEnable;
+}
+void BaseManager::setEnableSyncWrite(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramEnableSyncWrite.value = isEnable;
+}
+void BaseManager::setEnableGapRead(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramEnableGapRead.value = isEnable;
+}
+void BaseManager::setEnableBulkRead(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramEnableBulkRead.value = isEnable;
+}
+void BaseManager::setEnableBulkWrite(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramEnableBulkWrite.value = isEnable;
+}
+void BaseManager::setQuarantineFailures(unsigned int count)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramQuarantineFailures.value = count;
+}
+void BaseManager::setSchedulerConfig(double frequency, int priority, int cpu, bool isLockMemory)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramSchedulerFrequency.value = frequency;
+  _paramSchedulerPriority.value = priority;
+  _paramSchedulerCpu.value = cpu;
+  _paramSchedulerLockMemory.value = isLockMemory;
+}
+void BaseManager::setFlushBudget(double budget, unsigned int aging)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramFlushBudget.value = budget;
+  _paramFlushBudgetAging.value = aging;
+}
+void BaseManager::setSlowWriteProbe(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramSlowWriteProbe.value = isEnable;
+}
+void BaseManager::setStaggerPeriodicReads(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramStaggerPeriodicReads.value = isEnable;
+}
+void BaseManager::setSubscribedReadsOnly(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramSubscribedReadsOnly.value = isEnable;
+}
+void BaseManager::setForceCoalesceWindow(double window)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramForceCoalesceWindow.value = window;
+}
+void BaseManager::setWaitWriteCheckResponse(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramWaitWriteCheckResponse.value = isEnable;
+}
+void BaseManager::setPipelineWrites(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramPipelineWrites.value = isEnable;
+}
+void BaseManager::setThrowOnScan(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramThrowErrorOnScan.value = isEnable;
+}
+void BaseManager::setThrowOnRead(bool isEnable)
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _paramThrowErrorOnRead.value = isEnable;
+}
+
+void BaseManager::initBus()
+{
+  // Stop and free existing instances
+  closeBuses();
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  // Cached batch plans depend on Devices bus
+  _planCacheRead.clear();
+  _planCacheWrite.clear();
+  // Main bus port followed by extra ones
+  std::vector<std::string> ports = { _paramBusPort.value };
+  std::istringstream extraPorts(_paramBusExtraPorts.value);
+  std::string port;
+  while (std::getline(extraPorts, port, ','))
+  {
+    port.erase(0, port.find_first_not_of(' '));
+    port.erase(port.find_last_not_of(' ') + 1);
+    if (port != "")
+    {
+      ports.push_back(port);
+    }
+  }
+  if (_paramBusName.value != "SerialBus" && _paramBusName.value != "NativeSerialBus")
+  {
+    throw std::logic_error("BaseManager invalid bus name: " + _paramBusName.value);
+  }
+  // Allocate Bus and Protocol
+  // of each bus
+  for (size_t i = 0; i < ports.size(); i++)
+  {
+    _lines.push_back(std::unique_ptr<BusLine>(new BusLine()));
+    BusLine& line = *_lines.back();
+    line.bus = nullptr;
+    line.protocol = nullptr;
+    line.task = TaskNone;
+    line.packetOverhead = -1.0;
+    try
+    {
+      if (ports[i] != "")
+      {
+        try
+        {
+          if (_paramBusName.value == "NativeSerialBus")
+          {
+            line.bus = new NativeSerialBus(ports[i], _paramBusBaudrate.value, _paramBusLowLatency.value,
+                                           _paramBusLatencyTimer.value, _paramBusDrain.value);
+          }
+          else
+          {
+            line.bus = new SerialBus(ports[i], _paramBusBaudrate.value);
+          }
+        }
+        catch (const std::exception& e)
+        {
+          throw std::runtime_error(_paramBusName.value + " initialization failed:" + std::string(" port:") +
+                                   ports[i] + std::string(" exception: ") + std::string(e.what()));
+        }
+      }
+      line.protocol = ProtocolFactory(_paramProtocolName.value, *line.bus);
+      // Check that Protocol implementation name is valid
+      if (line.protocol == nullptr)
+      {
+        throw std::logic_error("BaseManager invalid protocol name: " + _paramProtocolName.value);
+      }
+    }
+    catch (...)
+    {
+      // Leave the Manager without bus
+      for (size_t k = 0; k < _lines.size(); k++)
+      {
+        delete _lines[k]->protocol;
+        delete _lines[k]->bus;
+      }
+      _lines.clear();
+      throw;
+    }
+  }
+  // Start the additional buses I/O threads
+  for (size_t i = 1; i < _lines.size(); i++)
+  {
+    _lines[i]->thread = std::thread(&BaseManager::busThread, this, i);
+  }
+}
+
+void BaseManager::closeBuses()
+{
+  // Stop the I/O threads
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    BusLine& line = *_lines[i];
+    if (line.thread.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lockTask(line.mutexTask);
+        line.task = TaskStop;
+      }
+      line.taskReady.notify_all();
+      line.thread.join();
+    }
+  }
+  // Free Bus and Protocol instances
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    delete _lines[i]->protocol;
+    delete _lines[i]->bus;
+  }
+  _lines.clear();
+}
+
+void BaseManager::pipelineBuses(bool isEnable)
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    std::lock_guard<std::mutex> lockLine(_lines[i]->mutex);
+    _lines[i]->protocol->setPipelined(isEnable);
+  }
+}
+
+BaseManager::BusLine& BaseManager::busLine(Device* dev)
+{
+  size_t bus = dev->bus();
+  if (bus >= _lines.size())
+  {
+    throw std::logic_error("BaseManager invalid bus for device: " + dev->name() + " bus=" + std::to_string(bus));
+  }
+  return *_lines[bus];
+}
+
+void BaseManager::torqueEnableAddresses(size_t bus, std::vector<id_t>& ids, std::vector<addr_t>& addresses) const
+{
+  ids.clear();
+  addresses.clear();
+  for (const auto& dev : _devicesById)
+  {
+    if (dev.second->bus() == bus && dev.second->registersList().exists("torqueEnable"))
+    {
+      ids.push_back(dev.first);
+      addresses.push_back(dev.second->registersList().reg("torqueEnable").addr);
+    }
+  }
+}
+
+void BaseManager::runBusTasks(BusTask task)
+{
+  // Hand the task to the I/O threads
+  for (size_t i = 1; i < _lines.size(); i++)
+  {
+    std::lock_guard<std::mutex> lockTask(_lines[i]->mutexTask);
+    _lines[i]->task = task;
+    _lines[i]->error = nullptr;
+    _lines[i]->taskReady.notify_all();
+  }
+  // The main bus share is run here
+  std::exception_ptr error = nullptr;
+  try
+  {
+    runBusTask(0, task);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  // Wait for all buses
+  for (size_t i = 1; i < _lines.size(); i++)
+  {
+    std::unique_lock<std::mutex> lockTask(_lines[i]->mutexTask);
+    _lines[i]->taskDone.wait(lockTask, [this, i]() { return _lines[i]->task == TaskNone; });
+    if (error == nullptr)
+    {
+      error = _lines[i]->error;
+    }
+  }
+  if (error != nullptr)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+void BaseManager::runBusTask(size_t bus, BusTask task)
+{
+  if (task == TaskWrite)
+  {
+    BatchPlan& plan = *_flushPlanWrite;
+    for (size_t i = 0; i < plan.bulks.size(); i++)
+    {
+      if (plan.bulks[i].bus == bus)
+      {
+        writeBulk(plan.bulks[i]);
+      }
+    }
+    for (size_t i = 0; i < plan.batches.size(); i++)
+    {
+      if (!plan.isBulkEnable && plan.batches[i].bus == bus)
+      {
+        writeBatch(plan.batches[i]);
+      }
+    }
+    // Ready made Device groups writes
+    writeDeviceGroups(bus);
+  }
+  else if (task == TaskRead)
+  {
+    BatchPlan& plan = *_flushPlanRead;
+    if (plan.isBulkEnable)
+    {
+      readWithinBudget(bus, plan.bulks, &BaseManager::readBulk, _flushBudget, _flushAging, _flushStart);
+    }
+    else
+    {
+      readWithinBudget(bus, plan.batches, &BaseManager::readBatch, _flushBudget, _flushAging, _flushStart);
+    }
+  }
+}
+
+void BaseManager::busThread(size_t bus)
+{
+  BusLine& line = *_lines[bus];
+  std::unique_lock<std::mutex> lockTask(line.mutexTask);
+  while (true)
+  {
+    line.taskReady.wait(lockTask, [&line]() { return line.task != TaskNone; });
+    if (line.task == TaskStop)
+    {
+      return;
+    }
+    BusTask task = line.task;
+    lockTask.unlock();
+    try
+    {
+      runBusTask(bus, task);
+    }
+    catch (...)
+    {
+      line.error = std::current_exception();
+    }
+    lockTask.lock();
+    line.task = TaskNone;
+    line.taskDone.notify_all();
+  }
+}
+
+void BaseManager::schedulerSetupThread()
+{
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  if (_paramSchedulerLockMemory.value)
+  {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+      std::cerr << "BaseManager scheduler mlockall failed: " << strerror(errno) << std::endl;
+    }
+  }
+  if (_paramSchedulerCpu.value >= 0)
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET((int)_paramSchedulerCpu.value, &cpus);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (error != 0)
+    {
+      std::cerr << "BaseManager scheduler affinity failed: " << strerror(error) << std::endl;
+    }
+  }
+  if (_paramSchedulerPriority.value > 0)
+  {
+    struct sched_param param;
+    param.sched_priority = (int)_paramSchedulerPriority.value;
+    int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0)
+    {
+      std::cerr << "BaseManager scheduler priority failed: " << strerror(error) << std::endl;
+    }
+  }
+}
+
+void BaseManager::schedulerWaitNextPeriod(TimePoint& deadline)
+{
+  double frequency;
+  {
+    std::lock_guard<std::mutex> lock(CallManager::_mutex);
+    frequency = _paramSchedulerFrequency.value;
+  }
+  if (frequency <= 0.0)
+  {
+    deadline = getTimePoint();
+    return;
+  }
+
+  // Next period start
+  deadline += std::chrono::duration_cast<TimePoint::duration>(TimeDurationFloat(1.0 / frequency));
+  TimePoint now = getTimePoint();
+  bool isMissed = (now > deadline);
+  if (!isMissed)
+  {
+    // Use the idle time left
+    readBackground(deadline);
+    // Sleep until the absolute deadline.
+    // TimePoint is based on steady_clock,
+    // which is CLOCK_MONOTONIC.
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+    now = getTimePoint();
+  }
+  // Delay between the target and the
+  // actual period start
+  TimeDurationMicro jitter = getTimeDuration<TimeDurationMicro>(deadline, now);
+  if (jitter.count() < 0)
+  {
+    jitter = TimeDurationMicro(0);
+  }
+  if (isMissed)
+  {
+    // Missed periods are skipped and
+    // the schedule restarts from now
+    deadline = now;
+  }
+
+  // Statistics
+  std::lock_guard<std::mutex> lock(CallManager::_mutex);
+  _stats.schedulerPeriodCount++;
+  if (isMissed)
+  {
+    _stats.schedulerDeadlineMissCount++;
+  }
+  size_t bucket = std::min((size_t)jitter.count(), SchedulerJitterBuckets - 1);
+  _stats.schedulerJitterHistogram[bucket]++;
+  if (jitter > _stats.maxSchedulerJitter)
+  {
+    _stats.maxSchedulerJitter = jitter;
+  }
+}
+
+void BaseManager::updateReadPeriods()
+{
+  if (!_isSubscriptionOutdated && _isSubscribedReadsOnly == _paramSubscribedReadsOnly.value &&
+      _readCycleCount % ReadPeriodUpdateCycles != 0)
+  {
+    return;
+  }
+  _isSubscriptionOutdated = false;
+  _isSubscribedReadsOnly = _paramSubscribedReadsOnly.value;
+
+  // Flush rate in Hz
+  // (negative if unknown)
+  double rate = -1.0;
+  if (_paramSchedulerFrequency.value > 0.0)
+  {
+    rate = _paramSchedulerFrequency.value;
+  }
+  else if (_measuredFlushPeriod > 0.0)
+  {
+    rate = 1.0 / _measuredFlushPeriod;
+  }
+  // Highest subscribed rate of each Register
+  std::fill(_subscribedFrequencies.begin(), _subscribedFrequencies.end(), 0.0);
+  for (size_t i = 0; i < _subscriptions.size(); i++)
+  {
+    if (_subscriptions[i].isActive)
+    {
+      double& frequency = _subscribedFrequencies[_subscriptions[i].reg->_managerIndex];
+      frequency = std::max(frequency, _subscriptions[i].frequency);
+    }
+  }
+  // The period is the largest number of cycles
+  // meeting the asked rate (with 5% tolerance
+  // against flush rate jitter)
+  for (size_t i = 0; i < _sortedRegisters.size(); i++)
+  {
+    Register* reg = _sortedRegisters[i];
+    unsigned int period;
+    if (_subscribedFrequencies[i] > 0.0)
+    {
+      period = 1;
+      if (rate > 0.0 && _subscribedFrequencies[i] != ReadEveryCycle)
+      {
+        period = (unsigned int)std::max(1.0, std::floor(rate / _subscribedFrequencies[i] + 0.05));
+      }
+    }
+    else
+    {
+      period = _isSubscribedReadsOnly ? 0 : reg->periodPackedRead;
+    }
+    if (reg->_readPeriod != period)
+    {
+      reg->_readPeriod = period;
+      _isScheduleOutdated = true;
+    }
+  }
+}
+
+void BaseManager::buildPeriodicSchedule()
+{
+  _isScheduleOutdated = false;
+  _isScheduleStaggered = _paramStaggerPeriodicReads.value;
+
+  // Group periodic Registers by Device
+  // and period. Registers are sorted by id.
+  struct DeviceReads
+  {
+    unsigned int period;
+    unsigned long load;
+    std::vector<size_t> indexes;
+  };
+  std::vector<DeviceReads> groups;
+  size_t deviceBegin = 0;
+  for (size_t i = 0; i < _sortedRegisters.size(); i++)
+  {
+    Register* reg = _sortedRegisters[i];
+    _sortedPhases[i] = 0;
+    unsigned int period = reg->readPeriod();
+    if (period == 0)
+    {
+      continue;
+    }
+    if (groups.size() > 0 && _sortedRegisters[groups.back().indexes.back()]->id != reg->id)
+    {
+      deviceBegin = groups.size();
+    }
+    size_t k = deviceBegin;
+    while (k < groups.size() && groups[k].period != period)
+    {
+      k++;
+    }
+    if (k == groups.size())
+    {
+      groups.push_back({ period, 0, {} });
+    }
+    groups[k].load += reg->length;
+    groups[k].indexes.push_back(i);
+  }
+
+  // The load is periodic over the least
+  // common multiple of all periods
+  unsigned long horizon = 1;
+  for (size_t k = 0; k < groups.size(); k++)
+  {
+    horizon = std::min((unsigned long)PeriodicScheduleHorizonMax,
+                       horizon / std::gcd(horizon, (unsigned long)groups[k].period) * groups[k].period);
+  }
+  _periodicLoad.assign(horizon, 0);
+
+  // Assign phases with fewest choices first
+  // and then heaviest groups first
+  std::stable_sort(groups.begin(), groups.end(), [](const DeviceReads& g1, const DeviceReads& g2) -> bool {
+    if (g1.period == g2.period)
+    {
+      return g1.load > g2.load;
+    }
+    else
+    {
+      return g1.period < g2.period;
+    }
+  });
+  _periodicSchedule.clear();
+  for (size_t k = 0; k < groups.size(); k++)
+  {
+    unsigned int period = groups[k].period;
+    // Select the phase whose heaviest
+    // cycle is the lightest
+    unsigned int phase = 0;
+    if (_isScheduleStaggered)
+    {
+      unsigned long bestLoad = (unsigned long)-1;
+      for (unsigned int p = 0; p < period && p < horizon; p++)
+      {
+        unsigned long load = 0;
+        for (size_t c = p; c < horizon; c += period)
+        {
+          load = std::max(load, _periodicLoad[c]);
+        }
+        if (load < bestLoad)
+        {
+          bestLoad = load;
+          phase = p;
+        }
+      }
+    }
+    for (size_t c = phase; c < horizon; c += period)
+    {
+      _periodicLoad[c] += groups[k].load;
+    }
+    // Merge into the schedule group
+    // with same period and phase
+    size_t l = 0;
+    while (l < _periodicSchedule.size() &&
+           (_periodicSchedule[l].period != period || _periodicSchedule[l].phase != phase))
+    {
+      l++;
+    }
+    if (l == _periodicSchedule.size())
+    {
+      _periodicSchedule.push_back({ period, phase, {} });
+    }
+    for (size_t i = 0; i < groups[k].indexes.size(); i++)
+    {
+      _sortedPhases[groups[k].indexes[i]] = phase;
+      _periodicSchedule[l].indexes.push_back(groups[k].indexes[i]);
+    }
+  }
+  for (size_t l = 0; l < _periodicSchedule.size(); l++)
+  {
+    std::sort(_periodicSchedule[l].indexes.begin(), _periodicSchedule[l].indexes.end());
+  }
+}
+
+bool BaseManager::isNeedRead(size_t index)
+{
+  Register* reg = _sortedRegisters[index];
+  Device* device = _sortedDevices[index];
+  unsigned int period = reg->readPeriod();
+
+  return (!device->dontRead()) && (!device->isQuarantined()) && (!device->isBusy()) &&
+         (reg->needRead() || (period > 0 && (_readCycleCount % period == _sortedPhases[index])));
+}
+
+bool BaseManager::isNeedWrite(size_t index)
+{
+  Register* reg = _sortedRegisters[index];
+  // Writes to quarantined or busy Devices
+  // are kept pending until readmission
+  Device* device = _sortedDevices[index];
+  if (device->isQuarantined() || device->isBusy())
+  {
+    return false;
+  }
+  bool isNeed = reg->needWrite();
+  // If selected for write, register
+  // is reset for write aggregation
+  if (isNeed)
+  {
+    reg->selectForWrite();
+  }
+  return isNeed;
+}
+
+BaseManager::BatchPlan& BaseManager::computeBatchedRegisters(bool isReadOrWrite)
+{
+  // SyncRead/Write is enable whenether
+  // configuration boolean are set
+  bool isSyncEnable = (isReadOrWrite && _paramEnableSyncRead.value) || (!isReadOrWrite && _paramEnableSyncWrite.value);
+  // Unused bytes are never written
+  _planMaxGaps.resize(_lines.size());
+  for (size_t i = 0; i < _lines.size(); i++)
+  {
+    _planMaxGaps[i] = isReadOrWrite ? computeMaxReadGap(i) : 0;
+  }
+  // Bulk operations are used if supported by the
+  // protocol. Bulk writes are never acknowledged.
+  bool isBulkEnable = _lines.size() > 0 && _lines.front()->protocol->isBulkSupported() &&
+                      ((isReadOrWrite && _paramEnableBulkRead.value) ||
+                       (!isReadOrWrite && _paramEnableBulkWrite.value && !_paramWaitWriteCheckResponse.value));
+
+  // Retrieve candidate registers indexes:
+  // dirty ones and periodic reads
+  // scheduled at this cycle
+  _planIndexes.clear();
+  if (isReadOrWrite)
+  {
+    updateReadPeriods();
+    if (_isScheduleOutdated || _isScheduleStaggered != _paramStaggerPeriodicReads.value)
+    {
+      buildPeriodicSchedule();
+    }
+    _dirtyRead.extract(_planIndexes);
+    bool isMerged = false;
+    for (size_t i = 0; i < _periodicSchedule.size(); i++)
+    {
+      if (_readCycleCount % _periodicSchedule[i].period == _periodicSchedule[i].phase)
+      {
+        _planIndexes.insert(_planIndexes.end(), _periodicSchedule[i].indexes.begin(),
+                            _periodicSchedule[i].indexes.end());
+        isMerged = true;
+      }
+    }
+    if (isMerged)
+    {
+      std::sort(_planIndexes.begin(), _planIndexes.end());
+      _planIndexes.erase(std::unique(_planIndexes.begin(), _planIndexes.end()), _planIndexes.end());
+    }
+  }
+  else
+  {
+    _dirtyWrite.extract(_planIndexes);
+  }
+
+  // Select registers according to
+  // the given predicate function.
+  // Indexes are sorted so the selection
+  // stays sorted by id and then by address
+  _planSelection.clear();
+  for (size_t i = 0; i < _planIndexes.size(); i++)
+  {
+    size_t index = _planIndexes[i];
+    Register* reg = _sortedRegisters[index];
+    if (isReadOrWrite && isNeedRead(index))
+    {
+      _planSelection.push_back(reg);
+    }
+    else if (!isReadOrWrite && isNeedWrite(index))
+    {
+      _planSelection.push_back(reg);
+    }
+    else if (isReadOrWrite && reg->needRead())
+    {
+      // Still pending (excluded Device).
+      // Asynchronous reads can not wait
+      // for the Device readmission.
+      reg->cancelAsyncReads();
+      _dirtyRead.insert(index);
+    }
+    else if (!isReadOrWrite && reg->needWrite())
+    {
+      _dirtyWrite.insert(index);
+    }
+  }
+
+  // Look for an already computed plan
+  // built from the same selection
+  std::vector<BatchPlan>& cache = isReadOrWrite ? _planCacheRead : _planCacheWrite;
+  for (size_t i = 0; i < cache.size(); i++)
+  {
+    if (cache[i].isSyncEnable == isSyncEnable && cache[i].maxGaps == _planMaxGaps && cache[i].isBulkEnable == isBulkEnable &&
+        cache[i].selection == _planSelection)
+    {
+      _stats.batchPlanReuseCount++;
+      cache[i].lastUsedCycle = _readCycleCount;
+      return cache[i];
+    }
+  }
+
+  // No plan found, the least recently
+  // used one is replaced
+  _stats.batchPlanRebuildCount++;
+  size_t index = cache.size();
+  if (cache.size() < BatchPlanCacheSize)
+  {
+    cache.push_back(BatchPlan());
+  }
+  else
+  {
+    index = 0;
+    for (size_t i = 1; i < cache.size(); i++)
+    {
+      if (cache[i].lastUsedCycle < cache[index].lastUsedCycle)
+      {
+        index = i;
+      }
+    }
+  }
+  BatchPlan& plan = cache[index];
+  plan.selection = _planSelection;
+  plan.isSyncEnable = isSyncEnable;
+  plan.maxGaps = _planMaxGaps;
+  plan.lastUsedCycle = _readCycleCount;
+  plan.isBulkEnable = isBulkEnable;
+  buildBatchPlan(plan.selection, isSyncEnable, plan.maxGaps, plan.batches);
+  plan.bulks.clear();
+  if (isBulkEnable)
+  {
+    buildBulkPlan(plan.batches, plan.bulks);
+  }
+
+  return plan;
+}
+
+void BaseManager::buildBatchPlan(const std::vector<Register*>& selection, bool isSyncEnable,
+                                 const std::vector<size_t>& maxGaps,
+                                 std::vector<BatchedRegisters>& container)
+{
+  container.clear();
+  // Index of final batches by
+  // bus, address and length
+  std::map<std::tuple<size_t, addr_t, size_t>, size_t> index;
+
+  // Merge the given temporary batch to
+  // final batches by merging by id
+  auto mergeById = [&container, &index, isSyncEnable](const BatchedRegisters& tmpBatch) {
+    // Already added final batches are looked up
+    // to find if the current batch can be merge
+    // with another batch by id with constant address
+    // and length.
+    if (isSyncEnable)
+    {
+      auto it = index.find(std::make_tuple(tmpBatch.bus, tmpBatch.addr, tmpBatch.length));
+      if (it != index.end())
+      {
+        BatchedRegisters& batch = container[it->second];
+        batch.regs.push_back(tmpBatch.regs.front());
+        batch.ids.push_back(tmpBatch.ids.front());
+        return;
+      }
+      index[std::make_tuple(tmpBatch.bus, tmpBatch.addr, tmpBatch.length)] = container.size();
+    }
+    // If no compatible final batch are
+    // found a new one is created
+    container.push_back(tmpBatch);
+  };
+
+  // Iterate over all selected Registers
+  // by id and then by address
+  BatchedRegisters tmpBatch;
+  for (size_t i = 0; i < selection.size(); i++)
+  {
+    Register* reg = selection[i];
+    // Initialize the temporary batch if empty
+    if (tmpBatch.regs.size() == 0)
+    {
+      tmpBatch.addr = reg->addr;
+      tmpBatch.length = reg->length;
+      tmpBatch.regs = { { reg } };
+      tmpBatch.ids = { reg->id };
+      tmpBatch.bus = _devicesById.at(reg->id)->bus();
+      tmpBatch.gapLength = 0;
+      // And continue to next register
+      continue;
+    }
+    // Registers are sorted by address, so
+    // the gap is always positive
+    size_t gap = reg->addr - (tmpBatch.addr + tmpBatch.length);
+    size_t maxGap = tmpBatch.bus < maxGaps.size() ? maxGaps[tmpBatch.bus] : 0;
+    bool isContigious = (tmpBatch.addr + tmpBatch.length <= reg->addr) && (gap <= maxGap) &&
+                        (reg->id == tmpBatch.ids.front());
+    if (isContigious)
+    {
+      // If the register is contigious (or close
+      // enough) to current batch, it is added to it.
+      // Registers are first batched by address
+      // with id constant.
+      // Gap bytes are read into the Device
+      // memory space and discarded.
+      tmpBatch.length += gap + reg->length;
+      tmpBatch.gapLength += gap;
+      tmpBatch.regs.front().push_back(reg);
+    }
+    else
+    {
+      // If the register is not contiguous,
+      // the temporaty batch is added to
+      // the final container.
+      mergeById(tmpBatch);
+      // And a new temporary batch is initialize
+      tmpBatch.addr = reg->addr;
+      tmpBatch.length = reg->length;
+      tmpBatch.regs = { { reg } };
+      tmpBatch.ids = { reg->id };
+      tmpBatch.bus = _devicesById.at(reg->id)->bus();
+      tmpBatch.gapLength = 0;
+    }
   }
   // Merge the last batch if not empty
   if (tmpBatch.regs.size() > 0)
   {
     mergeById(tmpBatch);
   }
+  // Precompute Protocol buffers
+  for (size_t i = 0; i < container.size(); i++)
+  {
+    BatchedRegisters& batch = container[i];
+    batch.datasRead.clear();
+    batch.datasWrite.clear();
+    for (size_t j = 0; j < batch.regs.size(); j++)
+    {
+      batch.datasRead.push_back(batch.regs[j].front()->_dataBufferRead);
+      batch.datasWrite.push_back(batch.regs[j].front()->_dataBufferWrite);
+    }
+    batch.states.assign(batch.ids.size(), ResponseQuiet);
+    batch.totalLength = batch.length * batch.ids.size();
+    batch.readDuration = -1.0;
+  }
+}
+
+void BaseManager::buildBulkPlan(const std::vector<BatchedRegisters>& batches, std::vector<BulkBatch>& bulks)
+{
+  bulks.clear();
+  // Iterate over all (id, batch) pairs
+  // and append each one to the first bulk
+  // of the same bus not containing the id yet
+  for (size_t i = 0; i < batches.size(); i++)
+  {
+    for (size_t j = 0; j < batches[i].ids.size(); j++)
+    {
+      id_t id = batches[i].ids[j];
+      size_t index = 0;
+      while (index < bulks.size() &&
+             (bulks[index].bus != batches[i].bus ||
+              std::find(bulks[index].ids.begin(), bulks[index].ids.end(), id) != bulks[index].ids.end()))
+      {
+        index++;
+      }
+      if (index == bulks.size())
+      {
+        bulks.push_back(BulkBatch());
+        bulks.back().bus = batches[i].bus;
+        bulks.back().totalLength = 0;
+        bulks.back().readDuration = -1.0;
+      }
+      BulkBatch& bulk = bulks[index];
+      bulk.ids.push_back(id);
+      bulk.addrs.push_back(batches[i].addr);
+      bulk.lengths.push_back(batches[i].length);
+      bulk.regs.push_back(batches[i].regs[j]);
+      bulk.datasRead.push_back(batches[i].regs[j].front()->_dataBufferRead);
+      bulk.datasWrite.push_back(batches[i].regs[j].front()->_dataBufferWrite);
+      bulk.states.push_back(ResponseQuiet);
+      bulk.totalLength += batches[i].length;
+    }
+  }
+}
+
+size_t BaseManager::computeMaxReadGap(size_t bus) const
+{
+  if (!_paramEnableGapRead.value || _paramBusBaudrate.value <= 0.0 || bus >= _lines.size())
+  {
+    return 0;
+  }
+  // Transfer time of one byte (start,
+  // 8 data bits and stop bit)
+  double byteDuration = 10.0 / _paramBusBaudrate.value;
+  // An additional transaction costs its request and
+  // response framing bytes plus the fixed overhead.
+  // Reading gap bytes is worth it while strictly cheaper.
+  double cost = _lines[bus]->protocol->transactionOverheadBytes() + packetOverhead(bus) / byteDuration;
+  if (cost <= 1.0)
+  {
+    return 0;
+  }
+  return (size_t)std::ceil(cost) - 1;
+}
 
-  return container;
+double BaseManager::packetOverhead(size_t bus) const
+{
+  double overhead = bus < _lines.size() ? _lines[bus]->packetOverhead.load() : -1.0;
+  return overhead >= 0.0 ? overhead : _paramPacketOverhead.value;
 }
 
 void BaseManager::writeBatch(BatchedRegisters& batch)
 {
-  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  std::unique_lock<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
+  BusLine& line = busLine(_devicesById.at(batch.ids.front()));
+  bool isParallel = _lines.size() > 1;
   // Registers stats
   for (size_t i = 0; i < batch.regs.size(); i++)
   {
@@ -1037,8 +2500,12 @@ void BaseManager::writeBatch(BatchedRegisters& batch)
     if (_paramWaitWriteCheckResponse.value)
     {
       // Write and check response state
-      ResponseState state = _protocol->writeAndCheckData(batch.ids.front(), batch.addr,
-                                                         batch.regs.front().front()->_dataBufferWrite, batch.length);
+      ResponseState state;
+      {
+        BusTransfer transfer(lockBus, line.mutex, isParallel);
+        state = line.protocol->writeAndCheckData(batch.ids.front(), batch.addr,
+                                                 batch.regs.front().front()->_dataBufferWrite, batch.length);
+      }
       // Check for communication error
       if (!checkResponseState(state, _devicesById.at(batch.ids.front())))
       {
@@ -1054,7 +2521,9 @@ void BaseManager::writeBatch(BatchedRegisters& batch)
     else
     {
       // Direct write no check case
-      _protocol->writeData(batch.ids.front(), batch.addr, batch.regs.front().front()->_dataBufferWrite, batch.length);
+      BusTransfer transfer(lockBus, line.mutex, isParallel);
+      line.protocol->writeData(batch.ids.front(), batch.addr, batch.regs.front().front()->_dataBufferWrite,
+                               batch.length);
     }
     TimePoint pStop = getTimePoint();
     _stats.writeCount++;
@@ -1069,16 +2538,15 @@ void BaseManager::writeBatch(BatchedRegisters& batch)
   else
   {
     // Synch Write multiple registers
-    std::vector<const data_t*> datas;
-    for (size_t i = 0; i < batch.regs.size(); i++)
-    {
-      datas.push_back(batch.regs[i].front()->_dataBufferWrite);
-    }
     TimePoint pStart = getTimePoint();
     if (_paramWaitWriteCheckResponse.value)
     {
       // Write and check response state
-      std::vector<ResponseState> states = _protocol->syncWriteAndCheck(batch.ids, batch.addr, datas, batch.length);
+      std::vector<ResponseState>& states = batch.states;
+      {
+        BusTransfer transfer(lockBus, line.mutex, isParallel);
+        line.protocol->syncWriteAndCheck(batch.ids, batch.addr, batch.datasWrite, batch.length, states);
+      }
       for (size_t i = 0; i < states.size(); i++)
       {
         // Check for communication error
@@ -1097,7 +2565,8 @@ void BaseManager::writeBatch(BatchedRegisters& batch)
     else
     {
       // Direct write no check case
-      _protocol->syncWrite(batch.ids, batch.addr, datas, batch.length);
+      BusTransfer transfer(lockBus, line.mutex, isParallel);
+      line.protocol->syncWrite(batch.ids, batch.addr, batch.datasWrite, batch.length);
     }
     TimePoint pStop = getTimePoint();
     _stats.syncWriteCount++;
@@ -1109,15 +2578,25 @@ void BaseManager::writeBatch(BatchedRegisters& batch)
       _stats.maxSyncWriteDuration = duration;
     }
   }
+  // Complete asynchronous writes
+  for (size_t i = 0; i < batch.regs.size(); i++)
+  {
+    for (size_t j = 0; j < batch.regs[i].size(); j++)
+    {
+      batch.regs[i][j]->finishWrite(!batch.regs[i][j]->_isLastWriteError);
+    }
+  }
 }
 void BaseManager::readBatch(BatchedRegisters& batch)
 {
-  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  std::unique_lock<std::mutex> lockBus(_mutexBus);
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (_lines.size() == 0)
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
+  BusLine& line = busLine(_devicesById.at(batch.ids.front()));
+  bool isParallel = _lines.size() > 1;
   // Reset read flags for all registers
   for (size_t i = 0; i < batch.regs.size(); i++)
   {
@@ -1131,6 +2610,7 @@ void BaseManager::readBatch(BatchedRegisters& batch)
   {
     _stats.regReadPerFlushAccu += batch.regs[i].size();
   }
+  _stats.gapReadLength += batch.gapLength * batch.ids.size();
 
   // Retrieve the read timestamp
   TimePoint timestamp;
@@ -1140,8 +2620,12 @@ void BaseManager::readBatch(BatchedRegisters& batch)
     // Read single register
     TimePoint pStart = getTimePoint();
 
-    ResponseState state =
-        _protocol->readData(batch.ids.front(), batch.addr, batch.regs.front().front()->_dataBufferRead, batch.length);
+    ResponseState state;
+    {
+      BusTransfer transfer(lockBus, line.mutex, isParallel);
+      state = line.protocol->readData(batch.ids.front(), batch.addr, batch.regs.front().front()->_dataBufferRead,
+                                      batch.length);
+    }
     TimePoint pStop = getTimePoint();
     _stats.readCount++;
     _stats.readLength += batch.length;
@@ -1151,6 +2635,26 @@ void BaseManager::readBatch(BatchedRegisters& batch)
     {
       _stats.maxReadDuration = duration;
     }
+    // Update the transaction overhead estimation
+    // from successful read minus bytes transfer
+    if ((state & ResponseOK) && _paramBusBaudrate.value > 0.0)
+    {
+      size_t bytes = line.protocol->transactionOverheadBytes() + batch.length;
+      double overhead = duration_float(duration) - 10.0 * bytes / _paramBusBaudrate.value;
+      if (overhead < 0.0)
+      {
+        overhead = 0.0;
+      }
+      double previous = line.packetOverhead.load();
+      if (previous < 0.0)
+      {
+        line.packetOverhead.store(overhead);
+      }
+      else
+      {
+        line.packetOverhead.store(0.95 * previous + 0.05 * overhead);
+      }
+    }
     // Check for communication error
     if (!checkResponseState(state, _devicesById.at(batch.ids.front())))
     {
@@ -1176,13 +2680,12 @@ void BaseManager::readBatch(BatchedRegisters& batch)
   else
   {
     // Synch Read multiple registers
-    std::vector<data_t*> datas;
-    for (size_t i = 0; i < batch.regs.size(); i++)
+    TimePoint pStart = getTimePoint();
+    std::vector<ResponseState>& states = batch.states;
     {
-      datas.push_back(batch.regs[i].front()->_dataBufferRead);
+      BusTransfer transfer(lockBus, line.mutex, isParallel);
+      line.protocol->syncRead(batch.ids, batch.addr, batch.datasRead, batch.length, states);
     }
-    TimePoint pStart = getTimePoint();
-    std::vector<ResponseState> states = _protocol->syncRead(batch.ids, batch.addr, datas, batch.length);
     TimePoint pStop = getTimePoint();
     _stats.syncReadCount++;
     _stats.syncReadLength += batch.length;
@@ -1221,12 +2724,567 @@ void BaseManager::readBatch(BatchedRegisters& batch)
   }
 }
 
+void BaseManager::writeBulk(BulkBatch& bulk)
+{
+  std::unique_lock<std::mutex> lockBus(_mutexBus);
+  // Check for initBus() called
+  if (_lines.size() == 0)
+  {
+    throw std::logic_error("BaseManager protocol not initialized");
+  }
+  BusLine& line = busLine(_devicesById.at(bulk.ids.front()));
+  // Registers stats
+  size_t length = 0;
+  for (size_t i = 0; i < bulk.regs.size(); i++)
+  {
+    _stats.regWrittenPerFlushAccu += bulk.regs[i].size();
+    length += bulk.lengths[i];
+  }
+  // Direct write no check case
+  TimePoint pStart = getTimePoint();
+  {
+    BusTransfer transfer(lockBus, line.mutex, _lines.size() > 1);
+    line.protocol->bulkWrite(bulk.ids, bulk.addrs, bulk.datasWrite, bulk.lengths);
+  }
+  TimePoint pStop = getTimePoint();
+  _stats.bulkWriteCount++;
+  _stats.bulkWriteLength += length;
+  TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+  _stats.sumBulkWriteDuration += duration;
+  if (_stats.maxBulkWriteDuration < duration)
+  {
+    _stats.maxBulkWriteDuration = duration;
+  }
+  // Complete asynchronous writes
+  for (size_t i = 0; i < bulk.regs.size(); i++)
+  {
+    for (size_t j = 0; j < bulk.regs[i].size(); j++)
+    {
+      bulk.regs[i][j]->finishWrite(true);
+    }
+  }
+}
+void BaseManager::readBulk(BulkBatch& bulk)
+{
+  std::unique_lock<std::mutex> lockBus(_mutexBus);
+  // Check for initBus() called
+  if (_lines.size() == 0)
+  {
+    throw std::logic_error("BaseManager protocol not initialized");
+  }
+  BusLine& line = busLine(_devicesById.at(bulk.ids.front()));
+  // Reset read flags for all registers
+  // and registers stats
+  size_t length = 0;
+  for (size_t i = 0; i < bulk.regs.size(); i++)
+  {
+    for (size_t j = 0; j < bulk.regs[i].size(); j++)
+    {
+      bulk.regs[i][j]->readyForRead();
+    }
+    _stats.regReadPerFlushAccu += bulk.regs[i].size();
+    length += bulk.lengths[i];
+  }
+
+  TimePoint pStart = getTimePoint();
+  std::vector<ResponseState>& states = bulk.states;
+  {
+    BusTransfer transfer(lockBus, line.mutex, _lines.size() > 1);
+    line.protocol->bulkRead(bulk.ids, bulk.addrs, bulk.datasRead, bulk.lengths, states);
+  }
+  TimePoint pStop = getTimePoint();
+  _stats.bulkReadCount++;
+  _stats.bulkReadLength += length;
+  TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(pStart, pStop);
+  _stats.sumBulkReadDuration += duration;
+  if (_stats.maxBulkReadDuration < duration)
+  {
+    _stats.maxBulkReadDuration = duration;
+  }
+  // Retrieve the read timestamp
+  TimePoint timestamp = averageTimePoints(pStart, pStop);
+
+  for (size_t i = 0; i < states.size(); i++)
+  {
+    // Check for communication error
+    if (!checkResponseState(states[i], _devicesById.at(bulk.ids[i])))
+    {
+      // Error case
+      // Re-ask the value at next cycle
+      for (size_t j = 0; j < bulk.regs[i].size(); j++)
+      {
+        bulk.regs[i][j]->readError();
+      }
+    }
+    else
+    {
+      // Valid case
+      // Assign timestamp on Manager side and
+      // mark for swapping
+      for (size_t j = 0; j < bulk.regs[i].size(); j++)
+      {
+        bulk.regs[i][j]->finishRead(timestamp);
+      }
+    }
+  }
+}
+
+template <typename T>
+void BaseManager::readWithinBudget(size_t bus, std::vector<T>& operations, void (BaseManager::*readFunc)(T&),
+                                   double budget, unsigned int aging, const TimePoint& start)
+{
+  // Sort given bus operations by priority
+  // class and then by plan order
+  BusLine& line = *_lines[bus];
+  std::vector<size_t>& order = line.readOrder;
+  std::vector<RegisterPriority>& priorities = line.readPriorities;
+  order.clear();
+  priorities.resize(operations.size(), PriorityHigh);
+  for (size_t i = 0; i < operations.size(); i++)
+  {
+    if (operations[i].bus == bus)
+    {
+      order.push_back(i);
+      priorities[i] = budget > 0.0 ? readPriority(operations[i].regs, aging) : PriorityHigh;
+    }
+  }
+  if (budget > 0.0)
+  {
+    std::sort(order.begin(), order.end(), [&priorities](size_t i, size_t j) {
+      return priorities[i] < priorities[j] || (priorities[i] == priorities[j] && i < j);
+    });
+  }
+
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    T& operation = operations[order[k]];
+    // Devices which have started a slow register
+    // write during this flush are not read. The
+    // other Devices of the operation still are.
+    T* issued = &operation;
+    if (isBusyOperation(operation.ids))
+    {
+      issued = &excludeBusy(line, operation);
+      if (issued->ids.size() == 0)
+      {
+        continue;
+      }
+    }
+    TimePoint pStart = getTimePoint();
+    // Lower priority operations are only issued
+    // if they fit in the remaining budget
+    if (priorities[order[k]] != PriorityHigh &&
+        duration_float(start, pStart) +
+                estimateReadDuration(bus, issued->ids.size(), issued->totalLength, issued->readDuration) >
+            budget)
+    {
+      deferRead(issued->regs);
+      continue;
+    }
+    (this->*readFunc)(*issued);
+    // Update the measured duration history
+    // of complete operations only
+    if (issued != &operation)
+    {
+      continue;
+    }
+    double duration = duration_float(pStart, getTimePoint());
+    if (operation.readDuration < 0.0)
+    {
+      operation.readDuration = duration;
+    }
+    else
+    {
+      operation.readDuration = 0.8 * operation.readDuration + 0.2 * duration;
+    }
+  }
+
+  if (budget > 0.0 && duration_float(start, getTimePoint()) > budget)
+  {
+    std::lock_guard<std::mutex> lockBus(_mutexBus);
+    _stats.flushBudgetOverrunCount++;
+  }
+}
+
+RegisterPriority BaseManager::readPriority(const std::vector<std::vector<Register*>>& regs, unsigned int aging) const
+{
+  RegisterPriority priority = PriorityLow;
+  for (size_t i = 0; i < regs.size(); i++)
+  {
+    for (size_t j = 0; j < regs[i].size(); j++)
+    {
+      priority = std::min(priority, regs[i][j]->agedPriority(aging));
+    }
+  }
+  return priority;
+}
+
+double BaseManager::estimateReadDuration(size_t bus, size_t count, size_t length, double measured) const
+{
+  if (measured >= 0.0)
+  {
+    return measured;
+  }
+  double overhead = packetOverhead(bus);
+  double byteDuration = _paramBusBaudrate.value > 0.0 ? 10.0 / _paramBusBaudrate.value : 0.0;
+  size_t overheadBytes = bus < _lines.size() ? _lines[bus]->protocol->transactionOverheadBytes() : 0;
+  return count * (overhead + overheadBytes * byteDuration) + length * byteDuration;
+}
+
+void BaseManager::deferRead(const std::vector<std::vector<Register*>>& regs)
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  for (size_t i = 0; i < regs.size(); i++)
+  {
+    for (size_t j = 0; j < regs[i].size(); j++)
+    {
+      regs[i][j]->deferRead();
+      _stats.readDeferredCount[regs[i][j]->priority()]++;
+    }
+  }
+}
+
+void BaseManager::probeQuarantined()
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  if (_quarantinedDevices.size() == 0)
+  {
+    return;
+  }
+  // Check for initBus() called
+  if (_lines.size() == 0)
+  {
+    throw std::logic_error("BaseManager protocol not initialized");
+  }
+  size_t i = 0;
+  while (i < _quarantinedDevices.size())
+  {
+    Device* dev = _quarantinedDevices[i];
+    if (_readCycleCount < dev->_quarantineNextProbe)
+    {
+      i++;
+      continue;
+    }
+    _stats.quarantineProbeCount++;
+    BusLine& line = busLine(dev);
+    bool isPresent;
+    {
+      ImmediateTransfer transfer(line);
+      isPresent = line.protocol->ping(dev->id());
+    }
+    if (isPresent)
+    {
+      // The Device is back, pending
+      // operations are resumed
+      dev->_consecutiveMissings = 0;
+      dev->setQuarantined(false);
+      dev->setPresent(true);
+      _quarantinedDevices.erase(_quarantinedDevices.begin() + i);
+      _stats.deviceReadmitCount++;
+    }
+    else
+    {
+      // Exponential backoff
+      dev->_quarantineBackoff = std::min((unsigned long)_paramQuarantineMaxBackoff.value,
+                                         2 * dev->_quarantineBackoff);
+      if (dev->_quarantineBackoff < 1)
+      {
+        dev->_quarantineBackoff = 1;
+      }
+      dev->_quarantineNextProbe = _readCycleCount + dev->_quarantineBackoff;
+      i++;
+    }
+  }
+}
+
+void BaseManager::beginSlowWrite(Device* dev)
+{
+  TimePoint now = getTimePoint();
+  _stats.slowWriteCount++;
+  if (!dev->_isBusy)
+  {
+    dev->_busyBegin = now;
+    dev->setBusy(true);
+    _busyDevices.push_back(dev);
+  }
+  dev->_busyEnd = now + std::chrono::milliseconds(SlowRegisterDelayMs);
+}
+
+void BaseManager::releaseBusy()
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  if (_busyDevices.size() == 0)
+  {
+    return;
+  }
+  TimePoint now = getTimePoint();
+  size_t i = 0;
+  while (i < _busyDevices.size())
+  {
+    Device* dev = _busyDevices[i];
+    bool isReady = (now >= dev->_busyEnd);
+    // Optionally, the Device answering a ping
+    // is assumed to have finished its write
+    if (!isReady && _paramSlowWriteProbe.value && _lines.size() > 0)
+    {
+      BusLine& line = busLine(dev);
+      ImmediateTransfer transfer(line);
+      if (line.protocol->ping(dev->id()))
+      {
+        isReady = true;
+        now = getTimePoint();
+        _stats.slowWriteProbeReleaseCount++;
+      }
+    }
+    if (isReady)
+    {
+      TimeDurationMicro duration = getTimeDuration<TimeDurationMicro>(dev->_busyBegin, now);
+      _stats.sumDeviceBusyDuration += duration;
+      if (_stats.maxDeviceBusyDuration < duration)
+      {
+        _stats.maxDeviceBusyDuration = duration;
+      }
+      dev->setBusy(false);
+      _busyDevices.erase(_busyDevices.begin() + i);
+    }
+    else
+    {
+      i++;
+    }
+  }
+}
+
+void BaseManager::readBackground(const TimePoint& deadline)
+{
+  size_t count = 0;
+  while (true)
+  {
+    // Select the next Register if its read
+    // is expected to end before the deadline
+    Register* reg;
+    Device* device;
+    {
+      std::lock_guard<std::mutex> lock(CallManager::_mutex);
+      if (count >= _backgroundReads.size())
+      {
+        return;
+      }
+      if (_backgroundNext >= _backgroundReads.size())
+      {
+        _backgroundNext = 0;
+      }
+      reg = _backgroundReads[_backgroundNext];
+      device = _devicesById.at(reg->id);
+      double duration = estimateReadDuration(device->bus(), 1, reg->length, -1.0) + _paramBackgroundReadMargin.value;
+      if (getTimePoint() + std::chrono::duration_cast<TimePoint::duration>(TimeDurationFloat(duration)) > deadline)
+      {
+        return;
+      }
+      _backgroundNext++;
+      count++;
+      if (device->dontRead() || device->isQuarantined() || device->isBusy())
+      {
+        continue;
+      }
+    }
+
+    std::lock_guard<std::mutex> lockBus(_mutexBus);
+    // Check for initBus() called
+    if (_lines.size() == 0)
+    {
+      throw std::logic_error("BaseManager protocol not initialized");
+    }
+    BusLine& line = busLine(device);
+    TimePoint pStart;
+    TimePoint pStop;
+    ResponseState state;
+    {
+      ImmediateTransfer transfer(line);
+      pStart = getTimePoint();
+      state = line.protocol->readData(reg->id, reg->addr, reg->_dataBufferRead, reg->length);
+      pStop = getTimePoint();
+    }
+    _stats.backgroundReadCount++;
+    _stats.backgroundReadLength += reg->length;
+    if (checkResponseState(state, device))
+    {
+      // Swapped at next flush
+      // as normal reads
+      reg->finishRead(averageTimePoints(pStart, pStop));
+    }
+    else
+    {
+      // Retried at next turn
+      _stats.backgroundReadErrorCount++;
+    }
+  }
+}
+
+void BaseManager::waitDeviceReady(Device* dev)
+{
+  while (true)
+  {
+    TimePoint busyEnd;
+    {
+      std::lock_guard<std::mutex> lockBus(_mutexBus);
+      if (!dev->_isBusy)
+      {
+        return;
+      }
+      busyEnd = dev->_busyEnd;
+    }
+    std::this_thread::sleep_until(busyEnd);
+    releaseBusy();
+  }
+}
+
+bool BaseManager::isBusyOperation(const std::vector<id_t>& ids)
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  if (_busyDevices.size() == 0)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    if (_devicesById.at(ids[i])->_isBusy)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+BaseManager::BatchedRegisters& BaseManager::excludeBusy(BusLine& line, const BatchedRegisters& batch)
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  BatchedRegisters& reduced = line.readReduced;
+  reduced.addr = batch.addr;
+  reduced.length = batch.length;
+  reduced.bus = batch.bus;
+  reduced.gapLength = batch.gapLength;
+  reduced.regs.clear();
+  reduced.ids.clear();
+  reduced.datasRead.clear();
+  reduced.datasWrite.clear();
+  for (size_t i = 0; i < batch.ids.size(); i++)
+  {
+    if (_devicesById.at(batch.ids[i])->_isBusy)
+    {
+      for (size_t j = 0; j < batch.regs[i].size(); j++)
+      {
+        batch.regs[i][j]->askRead();
+      }
+      continue;
+    }
+    reduced.regs.push_back(batch.regs[i]);
+    reduced.ids.push_back(batch.ids[i]);
+    reduced.datasRead.push_back(batch.datasRead[i]);
+  }
+  reduced.totalLength = reduced.length * reduced.ids.size();
+  reduced.readDuration = -1.0;
+  return reduced;
+}
+
+BaseManager::BulkBatch& BaseManager::excludeBusy(BusLine& line, const BulkBatch& bulk)
+{
+  std::lock_guard<std::mutex> lockBus(_mutexBus);
+  BulkBatch& reduced = line.readReducedBulk;
+  reduced.bus = bulk.bus;
+  reduced.ids.clear();
+  reduced.addrs.clear();
+  reduced.lengths.clear();
+  reduced.regs.clear();
+  reduced.datasRead.clear();
+  reduced.datasWrite.clear();
+  reduced.totalLength = 0;
+  for (size_t i = 0; i < bulk.ids.size(); i++)
+  {
+    if (_devicesById.at(bulk.ids[i])->_isBusy)
+    {
+      for (size_t j = 0; j < bulk.regs[i].size(); j++)
+      {
+        bulk.regs[i][j]->askRead();
+      }
+      continue;
+    }
+    reduced.ids.push_back(bulk.ids[i]);
+    reduced.addrs.push_back(bulk.addrs[i]);
+    reduced.lengths.push_back(bulk.lengths[i]);
+    reduced.regs.push_back(bulk.regs[i]);
+    reduced.datasRead.push_back(bulk.datasRead[i]);
+    reduced.totalLength += bulk.lengths[i];
+  }
+  reduced.readDuration = -1.0;
+  return reduced;
+}
+
 void BaseManager::swapRead()
 {
-  for (size_t i = 0; i < _sortedRegisters.size(); i++)
+  // Only Registers marked by
+  // finishRead() are swapped
+  _swapIndexes.clear();
+  _dirtySwap.extract(_swapIndexes);
+  for (size_t i = 0; i < _swapIndexes.size(); i++)
+  {
+    _sortedRegisters[_swapIndexes[i]]->swapRead();
+  }
+  if (_swapIndexes.size() > 0)
+  {
+    publishSnapshot();
+  }
+}
+
+void BaseManager::publishSnapshot()
+{
+  if (_snapshotNames.size() == 0)
+  {
+    return;
+  }
+  // Find a buffer held by no reader
+  // (the published one is held by _snapshot)
+  std::shared_ptr<StateSnapshot> buffer;
+  for (size_t i = 0; i < _snapshotPool.size(); i++)
+  {
+    if (_snapshotPool[i].use_count() == 1)
+    {
+      // use_count() is a relaxed load: order the last
+      // reader accesses before the buffer is overwritten
+      std::atomic_thread_fence(std::memory_order_acquire);
+      buffer = _snapshotPool[i];
+      break;
+    }
+  }
+  if (!buffer)
+  {
+    buffer = std::make_shared<StateSnapshot>();
+    _snapshotPool.push_back(buffer);
+  }
+
+  buffer->cycle = _readCycleCount;
+  buffer->date = getTimePoint();
+  buffer->ids = _snapshotIds;
+  buffer->names = _snapshotNames;
+  buffer->values.resize(_snapshotRegisters.size());
+  buffer->timestamps.resize(_snapshotRegisters.size());
+  buffer->errors.resize(_snapshotRegisters.size());
+  for (size_t i = 0; i < _snapshotRegisters.size(); i++)
   {
-    _sortedRegisters[i]->swapRead();
+    if (_snapshotRegisters[i] != nullptr)
+    {
+      ReadValueFloat value = _snapshotRegisters[i]->lastReadValue();
+      buffer->values[i] = value.value;
+      buffer->timestamps[i] = value.timestamp;
+      buffer->errors[i] = value.isError;
+    }
+    else
+    {
+      buffer->values[i] = std::numeric_limits<float>::quiet_NaN();
+      buffer->timestamps[i] = TimePoint();
+      buffer->errors[i] = true;
+    }
   }
+  std::atomic_store(&_snapshot, std::shared_ptr<const StateSnapshot>(buffer));
 }
 
 void BaseManager::swapCallBack()
@@ -1309,6 +3367,25 @@ bool BaseManager::checkResponseState(ResponseState state, Device* dev)
     {
       dev->setFlags(state);
     }
+    // Track consecutive missing responses
+    // and put the Device in quarantine
+    if (isPresent)
+    {
+      dev->_consecutiveMissings = 0;
+    }
+    else
+    {
+      dev->_consecutiveMissings++;
+      if (_paramQuarantineFailures.value > 0 && !dev->isQuarantined() &&
+          dev->_consecutiveMissings >= _paramQuarantineFailures.value)
+      {
+        dev->setQuarantined(true);
+        dev->_quarantineBackoff = 1;
+        dev->_quarantineNextProbe = _readCycleCount + 1;
+        _quarantinedDevices.push_back(dev);
+        _stats.deviceQuarantineCount++;
+      }
+    }
   }
 
   if (state & ResponseOK)
@@ -1322,16 +3399,16 @@ bool BaseManager::checkResponseState(ResponseState state, Device* dev)
   }
 }
 
-bool BaseManager::retrieveTypeNumber(id_t id, type_t& type)
+bool BaseManager::retrieveTypeNumber(size_t bus, id_t id, type_t& type)
 {
   // Check for initBus() called
-  if (_protocol == nullptr)
+  if (bus >= _lines.size())
   {
     throw std::logic_error("BaseManager protocol not initialized");
   }
   // Read at static memory address
   data_t* pt = reinterpret_cast<data_t*>(&type);
-  ResponseState state = _protocol->readData(id, AddrDevTypeNumber, pt, 2);
+  ResponseState state = _lines[bus]->protocol->readData(id, AddrDevTypeNumber, pt, 2);
 
   // Check response
   return checkResponseState(state, nullptr);
@@ -12,11 +12,16 @@
 #include <set>
 #include <string>
 #include <condition_variable>
+#include <memory>
 #include <exception>
+#include <atomic>
 #include "Statistics.hpp"
+#include "StateSnapshot.hpp"
+#include "DeviceGroup.hpp"
 #include "Device.hpp"
 #include "CallManager.hpp"
 #include "Bus/SerialBus.hpp"
+#include "Bus/NativeSerialBus.hpp"
 #include "Protocol/Protocol.hpp"
 #include "Protocol/ProtocolFactory.hpp"
 
@@ -98,7 +103,10 @@ public:
 
   /**
    * Immediately sends a broadcasted signal
-   * to put all the devices in emergency mode
+   * to put all the devices in emergency mode.
+   * Protocols without broadcast stop command
+   * address the known Devices torqueEnable
+   * Register first.
    */
   void emergencyStop();
 
@@ -135,10 +143,15 @@ public:
    *   Here, all threads are running.
    * - Perform all write operations.
    * - Perform all read operations.
+   *   If a time budget in seconds is given (or else
+   *   set in flushBudget parameter), high priority
+   *   reads are always performed and lower priority
+   *   ones only while the budget allows it. The others
+   *   are deferred to next flush.
    * - Optionnaly swap Registers (if isForceSwap is true)
    *   to apply immediatly read values.
    */
-  void flush(bool isForceSwap = true);
+  void flush(bool isForceSwap = true, double budget = -1.0);
 
   /**
    * Force all Registers to swap in order to
@@ -212,6 +225,78 @@ public:
   virtual void forceRegisterRead(id_t id, const std::string& name) override;
   virtual void forceRegisterWrite(id_t id, const std::string& name) override;
 
+  /**
+   * Inherit
+   * Return true if the Device with
+   * given id is never read
+   * (Called by register, not by user)
+   */
+  virtual bool isDeviceDontRead(id_t id) override;
+
+  /**
+   * Subscribe to the periodic read of the Register
+   * with given Device id and name at given rate in Hz
+   * (ReadEveryCycle for a read at each flush).
+   * The Register read period is derived from the highest
+   * rate of its active subscriptions and the flush rate
+   * (scheduler frequency or else measured).
+   * Return the subscription handle.
+   * Throw std::logic_error if the rate is not
+   * strictly positive or the Register is unknown.
+   */
+  size_t subscribeRead(id_t id, const std::string& name, double frequency);
+
+  /**
+   * Cancel the read subscription with given handle.
+   * Throw std::logic_error if the handle is not
+   * an active subscription.
+   */
+  void unsubscribeRead(size_t handle);
+
+  /**
+   * Add or remove the Register with given Device
+   * id and name to the background reads. Background
+   * reads are issued in turn by the Manager thread
+   * in the bus idle time left before the next
+   * scheduler period (only if schedulerFrequency is
+   * set). Read values are swapped as normal reads
+   * and force read Registers no longer read
+   * immediately on readValue().
+   * Throw std::logic_error if the Register is unknown.
+   */
+  void addBackgroundRead(id_t id, const std::string& name);
+  void removeBackgroundRead(id_t id, const std::string& name);
+
+  /**
+   * Create a group of Devices with given ids
+   * (in given order) whose float Registers with
+   * given name are written at once in a single
+   * sync write (see DeviceGroup). Quarantined and
+   * busy Devices are skipped. The group is owned
+   * by the Manager.
+   * Throw std::logic_error if a Device or Register
+   * is unknown, Registers are not compatible or
+   * Devices are not on the same bus.
+   */
+  DeviceGroup& addDeviceGroup(const std::vector<id_t>& ids, const std::string& name);
+
+  /**
+   * Set the names of float Registers copied into
+   * the state snapshot published at each swap for
+   * all current Devices (empty disables it).
+   * Throw std::logic_error if a Register with given
+   * name is not a float Register.
+   */
+  void setSnapshotRegisters(const std::vector<std::string>& names);
+
+  /**
+   * Return the last published state snapshot
+   * (nullptr if none) with a single atomic load.
+   * The snapshot is immutable and remains
+   * valid as long as it is held.
+   */
+  std::shared_ptr<const StateSnapshot> snapshot() const;
+
   /**
    * Return by copy all Manager Statistics
    */
@@ -230,9 +315,18 @@ public:
 
   /**
    * Read/Write access to Protocol Parameters list
+   * of the main bus or of the bus with given index
    */
   const ParametersList& protocolParametersList() const;
   ParametersList& protocolParametersList();
+  const ParametersList& protocolParametersList(size_t bus) const;
+  ParametersList& protocolParametersList(size_t bus);
+
+  /**
+   * Return the number of buses (the main
+   * bus and the extraPorts ones)
+   */
+  size_t busCount() const;
 
   /**
    * Set all Bus/Protocol configuration
@@ -246,7 +340,18 @@ public:
    */
   void setEnableSyncRead(bool isEnable);
   void setEnableSyncWrite(bool isEnable);
+  void setEnableGapRead(bool isEnable);
+  void setEnableBulkRead(bool isEnable);
+  void setEnableBulkWrite(bool isEnable);
+  void setQuarantineFailures(unsigned int count);
+  void setSchedulerConfig(double frequency, int priority = 0, int cpu = -1, bool isLockMemory = false);
+  void setFlushBudget(double budget, unsigned int aging = 4);
+  void setSlowWriteProbe(bool isEnable);
+  void setStaggerPeriodicReads(bool isEnable);
+  void setSubscribedReadsOnly(bool isEnable);
+  void setForceCoalesceWindow(double window);
   void setWaitWriteCheckResponse(bool isEnable);
+  void setPipelineWrites(bool isEnable);
   void setThrowOnScan(bool isEnable);
   void setThrowOnRead(bool isEnable);
 
@@ -285,7 +390,105 @@ protected:
    */
   void initBus();
 
+  /**
+   * Configure the calling thread as Manager
+   * thread according to the scheduler parameters
+   * (real time priority, CPU affinity and
+   * memory locking). Failures are reported
+   * on std::cerr.
+   */
+  void schedulerSetupThread();
+
+  /**
+   * Sleep until the next scheduler period start
+   * using an absolute deadline and update scheduler
+   * statistics. Given deadline is the current
+   * period start and is updated to the next one.
+   * Background reads are issued before sleeping.
+   * Return immediately if no frequency is set.
+   */
+  void schedulerWaitNextPeriod(TimePoint& deadline);
+
 private:
+  /**
+   * Internal structure for the
+   * indexes of periodically read
+   * Registers with a same period
+   * and phase
+   */
+  struct PeriodicReads
+  {
+    // Read period in flush cycles
+    unsigned int period;
+    // Read cycle offset in the period
+    unsigned int phase;
+    // Sorted Registers indexes
+    std::vector<size_t> indexes;
+  };
+
+  /**
+   * Internal structure for
+   * a Register read subscription
+   */
+  struct ReadSubscription
+  {
+    // Subscribed Register
+    Register* reg;
+    // Asked read rate in Hz
+    double frequency;
+    // False if cancelled
+    // (the slot can be reused)
+    bool isActive;
+  };
+
+  /**
+   * Internal structure for concurrent
+   * immediate reads or writes of a same
+   * address coalesced in a sync operation
+   */
+  struct ForceGroup
+  {
+    // Write or read operation
+    bool isWrite;
+    // Common address and length
+    addr_t addr;
+    size_t length;
+    // Requested Registers
+    // (with unique ids)
+    std::vector<Register*> regs;
+    // Bus of all Registers
+    size_t bus;
+    // Result of each request. On failure,
+    // the caller falls back to a single
+    // Register operation.
+    std::vector<bool> isSuccess;
+    // True once the operation is done
+    bool isFinished;
+  };
+
+  /**
+   * Scoped count of the forceRead()
+   * and forceWrite() calls in flight
+   */
+  class ForceCaller
+  {
+  public:
+    ForceCaller(BaseManager& manager) : _manager(manager)
+    {
+      std::lock_guard<std::mutex> lock(_manager._mutexForce);
+      _manager._forceCallerCount++;
+    }
+    ~ForceCaller()
+    {
+      std::lock_guard<std::mutex> lock(_manager._mutexForce);
+      _manager._forceCallerCount--;
+      _manager._forceGroupJoin.notify_all();
+    }
+
+  private:
+    BaseManager& _manager;
+  };
+
   /**
    * Internal structure
    * for a batch of registers
@@ -304,11 +507,201 @@ private:
     // Container of all unique ids
     // of batched registers
     std::vector<id_t> ids;
+    // Bus of all ids
+    size_t bus;
+    // Number of unused bytes read
+    // between registers of each id
+    size_t gapLength;
+    // Data buffers given to the Protocol
+    // and returned response states.
+    // Precomputed with the plan to avoid
+    // allocation during flush.
+    std::vector<data_t*> datasRead;
+    std::vector<const data_t*> datasWrite;
+    std::vector<ResponseState> states;
+    // Total bytes read for all ids
+    size_t totalLength;
+    // Smoothed measured read duration
+    // in seconds (negative if unknown)
+    double readDuration;
+  };
+
+  /**
+   * Internal structure for a bulk
+   * operation over several ids each
+   * with its own address and length
+   */
+  struct BulkBatch
+  {
+    // Unique ids with their start
+    // address and length
+    std::vector<id_t> ids;
+    std::vector<addr_t> addrs;
+    std::vector<size_t> lengths;
+    // Bus of all ids
+    size_t bus;
+    // Registers batched for each id
+    // sorted by Register address
+    std::vector<std::vector<Register*>> regs;
+    // Data buffers given to the Protocol
+    // and returned response states
+    std::vector<data_t*> datasRead;
+    std::vector<const data_t*> datasWrite;
+    std::vector<ResponseState> states;
+    // Total bytes read for all ids
+    size_t totalLength;
+    // Smoothed measured read duration
+    // in seconds (negative if unknown)
+    double readDuration;
+  };
+
+  /**
+   * Internal structure for
+   * a cached batching result
+   */
+  struct BatchPlan
+  {
+    // Selected registers the plan has been
+    // computed from (sorted by id and address)
+    std::vector<Register*> selection;
+    // Is sync read/write merging enabled
+    // when the plan was computed
+    bool isSyncEnable;
+    // Maximum gap in bytes allowed between batched
+    // registers of each bus when the plan was computed
+    std::vector<size_t> maxGaps;
+    // Is bulk read/write used
+    // when the plan was computed
+    bool isBulkEnable;
+    // Computed batches
+    std::vector<BatchedRegisters> batches;
+    // Computed batches regrouped into bulk
+    // operations if bulk is enabled
+    std::vector<BulkBatch> bulks;
+    // Last read cycle the plan was used
+    unsigned long lastUsedCycle;
+  };
+
+  /**
+   * Task run by a bus I/O thread
+   */
+  enum BusTask
+  {
+    TaskNone,
+    TaskWrite,
+    TaskRead,
+    TaskStop,
+  };
+
+  /**
+   * Internal structure for a bus with
+   * its Protocol. Additional buses have an
+   * I/O thread running their share of the
+   * flush operations.
+   */
+  struct BusLine
+  {
+    // Bus and Protocol instances
+    Bus* bus;
+    Protocol* protocol;
+    // Mutex serializing the bus transfers
+    std::mutex mutex;
+    // I/O thread, its assigned task
+    // and the task exception if any
+    std::thread thread;
+    std::mutex mutexTask;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+    BusTask task;
+    std::exception_ptr error;
+    // Read operations order and priority
+    // classes reused between flush() calls
+    // when the flush is time budgeted
+    std::vector<size_t> readOrder;
+    std::vector<RegisterPriority> readPriorities;
+    // Read operations without their busy
+    // Devices, reused between flush() calls
+    BatchedRegisters readReduced;
+    BulkBatch readReducedBulk;
+    // Current estimation in seconds of the fixed
+    // time cost of a transaction on this bus
+    // (negative if unknown). Updated under the
+    // Manager bus state lock, read without it.
+    std::atomic<double> packetOverhead;
+  };
+
+  /**
+   * Scoped bus transfer. The bus line is
+   * locked during the Protocol call. With several
+   * buses, the Manager bus state lock is released
+   * meanwhile so that buses transfer in parallel.
+   */
+  class BusTransfer
+  {
+  public:
+    BusTransfer(std::unique_lock<std::mutex>& lockBus, std::mutex& mutexLine, bool isParallel)
+      : _lockBus(lockBus), _mutexLine(mutexLine), _isParallel(isParallel)
+    {
+      if (_isParallel)
+      {
+        _lockBus.unlock();
+      }
+      _mutexLine.lock();
+    }
+    ~BusTransfer()
+    {
+      _mutexLine.unlock();
+      if (_isParallel)
+      {
+        _lockBus.lock();
+      }
+    }
+
+  private:
+    std::unique_lock<std::mutex>& _lockBus;
+    std::mutex& _mutexLine;
+    bool _isParallel;
+  };
+
+  /**
+   * Scoped bus line lock for operations
+   * issued outside the flush bus tasks (forced
+   * accesses, scan, ping, emergency). Requests
+   * queued by a pipelined flush are sent first
+   * and the operation itself is never queued.
+   */
+  class ImmediateTransfer
+  {
+  public:
+    ImmediateTransfer(BusLine& line) : _line(line), _isPipelined(false)
+    {
+      _line.mutex.lock();
+      try
+      {
+        _isPipelined = _line.protocol->isPipelined();
+        _line.protocol->setPipelined(false);
+      }
+      catch (...)
+      {
+        _line.mutex.unlock();
+        throw;
+      }
+    }
+    ~ImmediateTransfer()
+    {
+      _line.protocol->setPipelined(_isPipelined);
+      _line.mutex.unlock();
+    }
+
+  private:
+    BusLine& _line;
+    bool _isPipelined;
   };
 
   /**
    * Mutex protecting the shared
-   * communication bus
+   * communication bus state. A bus line
+   * mutex is always locked after it.
    */
   mutable std::mutex _mutexBus;
 
@@ -319,11 +712,86 @@ private:
    */
   std::vector<Register*> _sortedRegisters;
 
+  /**
+   * Device of each sorted Register
+   */
+  std::vector<Device*> _sortedDevices;
+
+  /**
+   * Periodic reads schedule grouped by
+   * period and phase. The Registers selected
+   * for read at a cycle are the dirty ones and
+   * the groups whose phase is the cycle modulo
+   * their period.
+   */
+  std::vector<PeriodicReads> _periodicSchedule;
+
+  /**
+   * Periodic read phase of each sorted Register
+   */
+  std::vector<unsigned int> _sortedPhases;
+
+  /**
+   * Predicted bytes read by periodic
+   * Registers at each cycle of the
+   * schedule horizon
+   */
+  std::vector<unsigned long> _periodicLoad;
+
+  /**
+   * True if the periodic reads schedule has
+   * to be rebuilt (Registers added or
+   * staggering configuration changed)
+   */
+  bool _isScheduleOutdated;
+  bool _isScheduleStaggered;
+
+  /**
+   * Read subscriptions indexed by handle
+   * and highest subscribed rate of each
+   * sorted Register (0 if none)
+   */
+  std::vector<ReadSubscription> _subscriptions;
+  std::vector<double> _subscribedFrequencies;
+
+  /**
+   * True if the Registers read period have
+   * to be updated (subscriptions changed or
+   * flush rate measured for the first time)
+   */
+  bool _isSubscriptionOutdated;
+  bool _isSubscribedReadsOnly;
+
+  /**
+   * Smoothed measured duration in seconds
+   * between two flush() calls (negative
+   * if unknown)
+   */
+  double _measuredFlushPeriod;
+
+  /**
+   * Candidate Registers indexes buffers
+   * reused between flush() calls
+   */
+  std::vector<size_t> _planIndexes;
+  std::vector<size_t> _swapIndexes;
+
   /**
    * Count all readFlush() calls
    */
   unsigned long _readCycleCount;
 
+  /**
+   * Cache of last computed batch plans
+   * for read and write operations.
+   * Selection buffer is reused between
+   * flush() calls to avoid allocations.
+   */
+  std::vector<BatchPlan> _planCacheRead;
+  std::vector<BatchPlan> _planCacheWrite;
+  std::vector<Register*> _planSelection;
+  std::vector<size_t> _planMaxGaps;
+
   /**
    * Condition variable for
    * the Manager waiting that
@@ -371,20 +839,50 @@ private:
   Statistics _stats;
 
   /**
-   * Serial bus and Protocol pointers
+   * Buses and their Protocol. The main
+   * bus has index 0. Always non empty
+   * once initBus() is called.
+   */
+  std::vector<std::unique_ptr<BusLine>> _lines;
+
+  /**
+   * Flush operations shared with the bus
+   * I/O threads: batch plans, read time budget,
+   * aging and bus operations start
    */
-  SerialBus* _bus;
-  Protocol* _protocol;
+  BatchPlan* _flushPlanRead;
+  BatchPlan* _flushPlanWrite;
+  double _flushBudget;
+  unsigned int _flushAging;
+  TimePoint _flushStart;
 
   /**
    * Bus and protocol parameters.
    * BusPort: system path to serial device.
    * BusBaudrate: serial port baudrate.
+   * BusName: Bus implementation (SerialBus
+   * or NativeSerialBus).
+   * BusLowLatency: NativeSerialBus low latency
+   * serial driver flag.
+   * BusLatencyTimer: NativeSerialBus FTDI
+   * latency timer in milliseconds (0 is unchanged).
+   * BusDrain: NativeSerialBus waits for the
+   * transmission of each packet.
+   * BusExtraPorts: comma separated system
+   * paths of additional buses (index 1 and
+   * more) using the same baudrate, Bus and
+   * Protocol. Devices are assigned to a bus
+   * with their bus parameter.
    * ProtocolName: textual name for Protocol.
    * (factory) instantiation
    */
   ParameterStr _paramBusPort;
   ParameterNumber _paramBusBaudrate;
+  ParameterStr _paramBusName;
+  ParameterBool _paramBusLowLatency;
+  ParameterNumber _paramBusLatencyTimer;
+  ParameterBool _paramBusDrain;
+  ParameterStr _paramBusExtraPorts;
   ParameterStr _paramProtocolName;
 
   /**
@@ -395,6 +893,184 @@ private:
   ParameterBool _paramEnableSyncRead;
   ParameterBool _paramEnableSyncWrite;
 
+  /**
+   * Gap tolerant read batching.
+   * EnableGapRead: if true, non contiguous registers
+   * of a same Device are read in one transaction
+   * when reading the unused bytes in between is
+   * cheaper than an additional transaction.
+   * PacketOverhead: initial estimation in seconds of
+   * the fixed time cost of a transaction (latency,
+   * timeout, turnaround) beside bytes transfer.
+   * The estimation is then updated from measured
+   * read durations.
+   */
+  ParameterBool _paramEnableGapRead;
+  ParameterNumber _paramPacketOverhead;
+
+  /**
+   * Bulk batching configuration.
+   * EnableBulkRead: if the protocol supports it,
+   * all read batches with different addresses are
+   * issued in a single protocol bulkRead.
+   * EnableBulkWrite: same for writes without
+   * check response.
+   */
+  ParameterBool _paramEnableBulkRead;
+  ParameterBool _paramEnableBulkWrite;
+
+  /**
+   * Unresponsive Devices quarantine.
+   * QuarantineFailures: number of consecutive
+   * quiet responses after which a Device is
+   * excluded from read and write operations
+   * (0 disables the quarantine).
+   * QuarantineMaxBackoff: maximum number of
+   * flush cycles between two ping probes of
+   * a quarantined Device. The probe period
+   * doubles after each unanswered ping.
+   */
+  ParameterNumber _paramQuarantineFailures;
+  ParameterNumber _paramQuarantineMaxBackoff;
+
+  /**
+   * Devices currently in quarantine
+   */
+  std::vector<Device*> _quarantinedDevices;
+
+  /**
+   * Slow register writes.
+   * SlowWriteProbe: if true, Devices in a slow
+   * register write window are pinged at each flush
+   * and readmitted as soon as they answer, before
+   * the end of the window.
+   */
+  ParameterBool _paramSlowWriteProbe;
+
+  /**
+   * Devices currently excluded from
+   * the bus by a slow register write
+   */
+  std::vector<Device*> _busyDevices;
+
+  /**
+   * Immediate read and write coalescing.
+   * ForceCoalesceWindow: time in microseconds
+   * a forceRead() or forceWrite() call waits for
+   * concurrent calls to the same address on other
+   * Devices before issuing a single sync operation
+   * (0 disables coalescing). The wait ends as soon
+   * as every other call in flight has joined and is
+   * skipped when no other call is in flight. Else a
+   * request may be delayed by up to the window.
+   */
+  ParameterNumber _paramForceCoalesceWindow;
+
+  /**
+   * Coalescing groups still open to new
+   * requests, mutex protecting them and
+   * conditions notified when a group
+   * operation is done or when a call joins
+   * a group or ends
+   */
+  std::vector<std::shared_ptr<ForceGroup>> _forceGroups;
+  std::mutex _mutexForce;
+  std::condition_variable _forceGroupDone;
+  std::condition_variable _forceGroupJoin;
+
+  /**
+   * Number of forced calls in flight
+   * and of those waiting in a group
+   * (protected by _mutexForce)
+   */
+  size_t _forceCallerCount;
+  size_t _forceGroupedCount;
+
+  /**
+   * Device groups written at each flush
+   * (protected by both _mutex and _mutexBus)
+   */
+  std::vector<std::unique_ptr<DeviceGroup>> _deviceGroups;
+
+  /**
+   * State snapshot configuration: Devices id,
+   * Register names and Registers of each snapshot
+   * cell (column after column, nullptr if
+   * the Device has no such Register)
+   */
+  std::vector<id_t> _snapshotIds;
+  std::vector<std::string> _snapshotNames;
+  std::vector<TypedRegisterFloat*> _snapshotRegisters;
+
+  /**
+   * Snapshot buffers reused once no reader
+   * holds them and last published snapshot
+   * (accessed with std::atomic_load/store)
+   */
+  std::vector<std::shared_ptr<StateSnapshot>> _snapshotPool;
+  std::shared_ptr<const StateSnapshot> _snapshot;
+
+  /**
+   * Registers read in scheduler idle time
+   * and index of the next one to read
+   */
+  std::vector<Register*> _backgroundReads;
+  size_t _backgroundNext;
+
+  /**
+   * Background reads.
+   * BackgroundReadMargin: time in seconds kept
+   * free before the next scheduler period in
+   * addition to the estimated read duration.
+   */
+  ParameterNumber _paramBackgroundReadMargin;
+
+  /**
+   * Periodic reads staggering.
+   * StaggerPeriodicReads: if true, the periodic
+   * reads of each Device are given a phase in
+   * their period such that the bytes read per
+   * cycle are balanced. If false, all Registers
+   * with a same period are read at the same cycle.
+   */
+  ParameterBool _paramStaggerPeriodicReads;
+
+  /**
+   * Read subscriptions.
+   * SubscribedReadsOnly: if true, Registers without
+   * active read subscription are not read periodically.
+   * If false, they keep their default read period.
+   */
+  ParameterBool _paramSubscribedReadsOnly;
+
+  /**
+   * Fixed rate Manager thread scheduler.
+   * SchedulerFrequency: target flush frequency
+   * in Hz (0 runs flush() back to back).
+   * SchedulerPriority: if strictly positive,
+   * SCHED_FIFO priority of the Manager thread.
+   * SchedulerCpu: if positive, CPU the Manager
+   * thread is pinned to.
+   * SchedulerLockMemory: if true, the process
+   * memory is locked with mlockall().
+   */
+  ParameterNumber _paramSchedulerFrequency;
+  ParameterNumber _paramSchedulerPriority;
+  ParameterNumber _paramSchedulerCpu;
+  ParameterBool _paramSchedulerLockMemory;
+
+  /**
+   * Flush time budget.
+   * FlushBudget: default bus time budget in
+   * seconds for write and read operations of
+   * each flush (0 for unlimited).
+   * FlushBudgetAging: number of consecutive
+   * deferrals after which a read is promoted
+   * to the next higher priority class.
+   */
+  ParameterNumber _paramFlushBudget;
+  ParameterNumber _paramFlushBudgetAging;
+
   /**
    * Write check behaviour. If false, the Manager
    * assume that write protocol command does not
@@ -404,6 +1080,18 @@ private:
    */
   ParameterBool _paramWaitWriteCheckResponse;
 
+  /**
+   * Pipelined flush. If true, writes without
+   * check response of a flush are queued by the
+   * Protocol and sent back to back in a single
+   * bus transfer, ahead of the first request
+   * expecting a response (or together with it
+   * if the Protocol has no delay after writes).
+   * Operations issued by users meanwhile send
+   * the queue first and are never queued.
+   */
+  ParameterBool _paramPipelineWrites;
+
   /**
    * Exception error configuration.
    * If true, an std::runtime_error exception
@@ -417,21 +1105,158 @@ private:
   ParameterBool _paramThrowErrorOnRead;
 
   /**
-   * Return true if given Register pointer
-   * is mark has to be read or write
+   * Exclude given Device from read and write
+   * operations during a slow register write window
+   * starting now. (The bus has to be locked)
+   */
+  void beginSlowWrite(Device* dev);
+
+  /**
+   * Readmit busy Devices whose slow register write
+   * window has elapsed (or answering a readiness ping
+   * probe if enabled)
+   */
+  void releaseBusy();
+
+  /**
+   * Send the values of the Device groups on
+   * given bus written since last flush. Values
+   * of quarantined or busy Devices are kept
+   * pending for a next flush.
+   */
+  void writeDeviceGroups(size_t bus);
+
+  /**
+   * Copy the snapshot Registers into a free
+   * buffer and publish it
+   */
+  void publishSnapshot();
+
+  /**
+   * Try to serve an immediate read or write of
+   * given Register by a sync operation shared with
+   * concurrent requests to the same address.
+   * Return true if the request has been served.
+   * If false, the caller has to perform the single
+   * Register operation (coalescing disabled,
+   * no concurrent request or failure).
+   * (No lock has to be held)
+   */
+  bool forceCoalesce(Register* reg, bool isWrite);
+
+  /**
+   * Perform the sync operation of
+   * given coalesced requests group
+   */
+  void forceGroupOperation(ForceGroup& group);
+
+  /**
+   * Issue background reads in turn while
+   * they are expected to end before given
+   * deadline. Each Register is read at
+   * most once per call.
+   */
+  void readBackground(const TimePoint& deadline);
+
+  /**
+   * Block the calling thread until given
+   * Device is no longer busy.
+   * (No lock has to be held)
+   */
+  void waitDeviceReady(Device* dev);
+
+  /**
+   * Return true if at least one of
+   * given Device ids is busy
+   */
+  bool isBusyOperation(const std::vector<id_t>& ids);
+
+  /**
+   * Copy given read operation without its busy
+   * Devices into the bus line reduced operation and
+   * return it. The Registers of busy Devices are
+   * asked for read at next flush().
    */
-  bool isNeedRead(Register* reg);
-  bool isNeedWrite(Register* reg);
+  BatchedRegisters& excludeBusy(BusLine& line, const BatchedRegisters& batch);
+  BulkBatch& excludeBusy(BusLine& line, const BulkBatch& bulk);
 
   /**
-   * Iterate over all registers and batch them
-   * into compatible groups (address and length).
+   * Update the Registers read period from
+   * active subscriptions and the flush rate
+   * if subscriptions changed or every
+   * ReadPeriodUpdateCycles cycles.
+   * The periodic reads schedule is outdated
+   * if a period is changed.
+   */
+  void updateReadPeriods();
+
+  /**
+   * Rebuild the periodic reads schedule.
+   * Registers of a same Device and period are
+   * kept in one group. If staggering is enabled,
+   * each group is given the phase with the lowest
+   * predicted load, longest groups and shortest
+   * periods first.
+   */
+  void buildPeriodicSchedule();
+
+  /**
+   * Return true if the Register with given
+   * index is mark has to be read or write
+   */
+  bool isNeedRead(size_t index);
+  bool isNeedWrite(size_t index);
+
+  /**
+   * Batch the registers needing work into
+   * compatible groups (address and length).
    * If isReadOrWrite is true, registers needing
-   * read are selected.
-   * If isReadOrWrite is false, registers needing
-   * write are selected.
+   * read are selected among the dirty and periodic
+   * ones of current cycle.
+   * If isReadOrWrite is false, dirty registers
+   * needing write are selected.
+   * A cached plan is returned if the same registers
+   * selection has already been batched. The returned
+   * reference is valid until next call with
+   * the same isReadOrWrite.
+   */
+  BatchPlan& computeBatchedRegisters(bool isReadOrWrite);
+
+  /**
+   * Batch the given selection of registers
+   * (sorted by id and then by address) into
+   * the given batches container.
+   * Batches are merged by id if isSyncEnable is true.
+   * Registers of a same id separated by at most
+   * maxGaps[bus] unused bytes are batched together.
    */
-  std::vector<BatchedRegisters> computeBatchedRegisters(bool isReadOrWrite);
+  void buildBatchPlan(const std::vector<Register*>& selection, bool isSyncEnable, const std::vector<size_t>& maxGaps,
+                      std::vector<BatchedRegisters>& container);
+
+  /**
+   * Regroup given batches into bulk operations.
+   * Each id appears only once per bulk operation
+   * so a Device with several batches is spread
+   * over several bulk operations.
+   */
+  void buildBulkPlan(const std::vector<BatchedRegisters>& batches, std::vector<BulkBatch>& bulks);
+
+  /**
+   * Return the maximum number of unused bytes
+   * that is cheaper to read than issuing an other
+   * read transaction on given bus, with respect to
+   * current baudrate and estimated transaction overhead.
+   * Zero is returned if gap read is disabled.
+   */
+  size_t computeMaxReadGap(size_t bus) const;
+
+  /**
+   * Return the estimated fixed time cost in
+   * seconds of a transaction on given bus
+   * (measured if known, else the
+   * PacketOverhead parameter)
+   */
+  double packetOverhead(size_t bus) const;
 
   /**
    * Actually Write and Read on the bus
@@ -440,6 +1265,101 @@ private:
   void writeBatch(BatchedRegisters& batch);
   void readBatch(BatchedRegisters& batch);
 
+  /**
+   * Actually Write and Read on the bus
+   * given bulk batched Registers
+   */
+  void writeBulk(BulkBatch& bulk);
+  void readBulk(BulkBatch& bulk);
+
+  /**
+   * Perform read operation on given batches
+   * or bulks using given read method.
+   * If budget is positive, operations are issued
+   * by priority class. High priority ones are always
+   * issued, others only if their estimated duration
+   * fits in the budget remaining since given start
+   * time point. Else they are deferred.
+   * Only the operations of given bus are issued.
+   */
+  template <typename T>
+  void readWithinBudget(size_t bus, std::vector<T>& operations, void (BaseManager::*readFunc)(T&), double budget,
+                        unsigned int aging, const TimePoint& start);
+
+  /**
+   * Return the bus line of given Device.
+   * Throw std::logic_error if the Device bus
+   * parameter is not a configured bus.
+   */
+  BusLine& busLine(Device* dev);
+
+  /**
+   * Assign the ids of the known Devices on
+   * given bus having a torqueEnable Register
+   * and the address of this Register
+   */
+  void torqueEnableAddresses(size_t bus, std::vector<id_t>& ids, std::vector<addr_t>& addresses) const;
+
+  /**
+   * Run given flush task on all buses, the main
+   * bus in calling thread and the others in their
+   * I/O thread, and wait for all of them.
+   * The first thrown exception is rethrown.
+   */
+  void runBusTasks(BusTask task);
+
+  /**
+   * Run given flush task on the
+   * operations of given bus
+   */
+  void runBusTask(size_t bus, BusTask task);
+
+  /**
+   * I/O thread main loop of given bus
+   */
+  void busThread(size_t bus);
+
+  /**
+   * Stop I/O threads and free all
+   * buses and Protocol instances
+   */
+  void closeBuses();
+
+  /**
+   * Enable or disable the Protocol
+   * pipelined mode of all buses
+   */
+  void pipelineBuses(bool isEnable);
+
+  /**
+   * Return the highest aged priority
+   * class of given batched registers
+   */
+  RegisterPriority readPriority(const std::vector<std::vector<Register*>>& regs, unsigned int aging) const;
+
+  /**
+   * Return the estimated duration in seconds of
+   * a read operation on given bus and number of
+   * devices for given total length. The measured
+   * duration is used if known (positive), else it is
+   * estimated from the bus transaction overhead
+   * and baudrate.
+   */
+  double estimateReadDuration(size_t bus, size_t count, size_t length, double measured) const;
+
+  /**
+   * Defer the read of given batched
+   * registers to next flush()
+   */
+  void deferRead(const std::vector<std::vector<Register*>>& regs);
+
+  /**
+   * Ping quarantined Devices whose probe
+   * cycle is reached and readmit the
+   * ones answering
+   */
+  void probeQuarantined();
+
   /**
    * Iterate over all registers and
    * swap then to apply read change if
@@ -467,11 +1387,12 @@ private:
 
   /**
    * Try to read the Device model number
-   * from given id and assign into given type.
-   * True is returned if read is successful.
+   * from given id on given bus and assign into
+   * given type. True is returned if read
+   * is successful.
    * (The bus access is supposed to be locked)
    */
-  bool retrieveTypeNumber(id_t id, type_t& type);
+  bool retrieveTypeNumber(size_t bus, id_t id, type_t& type);
 };
 
 }  // namespace RhAL
@@ -2,7 +2,7 @@
 
 namespace RhAL
 {
-CallManager::CallManager() : _paramScheduleMode("scheduleMode", true)
+CallManager::CallManager() : _paramScheduleMode("scheduleMode", true), _dirtyRead(), _dirtyWrite(), _dirtySwap()
 {
 }
 
@@ -21,4 +21,17 @@ void CallManager::setScheduleMode(bool mode)
   _paramScheduleMode.value = mode;
 }
 
+void CallManager::markNeedRead(size_t index)
+{
+  _dirtyRead.insert(index);
+}
+void CallManager::markNeedWrite(size_t index)
+{
+  _dirtyWrite.insert(index);
+}
+void CallManager::markNeedSwap(size_t index)
+{
+  _dirtySwap.insert(index);
+}
+
 }  // namespace RhAL
@@ -5,6 +5,7 @@
 #include "types.h"
 #include "timestamp.h"
 #include "Parameter.hpp"
+#include "DirtySet.hpp"
 
 namespace RhAL
 {
@@ -49,6 +50,13 @@ public:
   virtual void forceRegisterRead(id_t id, const std::string& name) = 0;
   virtual void forceRegisterWrite(id_t id, const std::string& name) = 0;
 
+  /**
+   * Return true if the Device with
+   * given id is never read (dontRead
+   * parameter)
+   */
+  virtual bool isDeviceDontRead(id_t id) = 0;
+
   /**
    * Return the current Manager send mode.
    * If true, all Registers Read and Write
@@ -67,6 +75,16 @@ public:
    */
   void setScheduleMode(bool mode);
 
+  /**
+   * Mark the Register with given Manager
+   * index as needing read, write or swap.
+   * Lock free.
+   * (Called by Register)
+   */
+  void markNeedRead(size_t index);
+  void markNeedWrite(size_t index);
+  void markNeedSwap(size_t index);
+
 protected:
   /**
    * Send mode. If false (default behaviour is true),
@@ -81,6 +99,15 @@ protected:
    * but not protecting the bus access
    */
   mutable std::mutex _mutex;
+
+  /**
+   * Manager indexes of Registers marked as
+   * needing read, write or swap since
+   * last Manager extraction
+   */
+  DirtySet _dirtyRead;
+  DirtySet _dirtyWrite;
+  DirtySet _dirtySwap;
 };
 
 }  // namespace RhAL
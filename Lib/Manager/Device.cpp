@@ -17,7 +17,16 @@ Device::Device(const std::string& name, id_t id)
   , _countWarnings(0)
   , _countErrors(0)
   , _countMissings(0)
+  , _countQuarantines(0)
+  , _consecutiveMissings(0)
+  , _isQuarantined(false)
+  , _quarantineBackoff(0)
+  , _quarantineNextProbe(0)
+  , _isBusy(false)
+  , _busyBegin()
+  , _busyEnd()
   , _dontRead("dontRead", false)
+  , _bus("bus", 0)
 {
   if (id < IdDevBegin || id > IdDevEnd)
   {
@@ -48,6 +57,8 @@ void Device::init()
 
   // Adding dontRead parameter
   Device::parametersList().add(&_dontRead);
+  // Adding bus parameter
+  Device::parametersList().add(&_bus);
 
   // Call
   onInit();
@@ -81,12 +92,30 @@ bool Device::isError() const
   return _isError;
 }
 
+bool Device::isQuarantined() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _isQuarantined;
+}
+
+bool Device::isBusy() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _isBusy;
+}
+
 bool Device::dontRead()
 {
   std::lock_guard<std::mutex> lock(_mutex);
   return _dontRead.value;
 }
 
+size_t Device::bus()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _bus.value > 0.0 ? (size_t)_bus.value : 0;
+}
+
 ResponseState Device::lastFlags() const
 {
   std::lock_guard<std::mutex> lock(_mutex);
@@ -105,6 +134,10 @@ unsigned long Device::countMissings() const
 {
   return _countMissings;
 }
+unsigned long Device::countQuarantines() const
+{
+  return _countQuarantines;
+}
 
 const RegistersList& Device::registersList() const
 {
@@ -155,5 +188,19 @@ void Device::setError(bool isError)
     _countErrors++;
   }
 }
+void Device::setQuarantined(bool isQuarantined)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (isQuarantined && !_isQuarantined)
+  {
+    _countQuarantines++;
+  }
+  _isQuarantined = isQuarantined;
+}
+void Device::setBusy(bool isBusy)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _isBusy = isBusy;
+}
 
 }  // namespace RhAL
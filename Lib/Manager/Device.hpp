@@ -103,11 +103,33 @@ public:
    */
   bool isError() const;
 
+  /**
+   * If true, the Device has stopped
+   * answering and is excluded from
+   * read and write operations until it
+   * answers again to a ping probe
+   */
+  bool isQuarantined() const;
+
+  /**
+   * If true, a slow register (EEPROM) write
+   * is in progress on the Device and it is
+   * excluded from read and write operations
+   * until its write window has elapsed
+   */
+  bool isBusy() const;
+
   /**
    * Read the dontRead parameter
    */
   bool dontRead();
 
+  /**
+   * Return the index of the Manager bus
+   * the Device is connected to (bus parameter)
+   */
+  size_t bus();
+
   /**
    * Return the number of
    * warnings, errors ans missing
@@ -116,6 +138,7 @@ public:
   unsigned long countWarnings() const;
   unsigned long countErrors() const;
   unsigned long countMissings() const;
+  unsigned long countQuarantines() const;
 
   /**
    * Read/Write access to Registers and
@@ -139,6 +162,8 @@ protected:
   void setPresent(bool isPresent);
   void setWarning(bool isWarning);
   void setError(bool isError);
+  void setQuarantined(bool isQuarantined);
+  void setBusy(bool isBusy);
 
   /**
    * And set last warning and error flags.
@@ -230,11 +255,41 @@ private:
   unsigned long _countWarnings;
   unsigned long _countErrors;
   unsigned long _countMissings;
+  unsigned long _countQuarantines;
+
+  /**
+   * Link health state (accessed by the Manager
+   * with the bus locked): number of consecutive
+   * quiet responses, quarantine flag, current
+   * ping probe backoff period and next probe
+   * cycle
+   */
+  unsigned int _consecutiveMissings;
+  bool _isQuarantined;
+  unsigned long _quarantineBackoff;
+  unsigned long _quarantineNextProbe;
+
+  /**
+   * Slow register write state (accessed by
+   * the Manager with the bus locked): busy flag
+   * and begin and end of the write window
+   */
+  bool _isBusy;
+  TimePoint _busyBegin;
+  TimePoint _busyEnd;
 
   /**
    * Parameter to avoid reading from this device
    */
   ParameterBool _dontRead;
+
+  /**
+   * Index of the Manager bus the device
+   * is connected to (0 is the main bus).
+   * Changes are taken into account at
+   * next Manager initBus().
+   */
+  ParameterNumber _bus;
 };
 
 }  // namespace RhAL
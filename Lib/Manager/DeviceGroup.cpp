@@ -0,0 +1,78 @@
+#include <stdexcept>
+#include "DeviceGroup.hpp"
+
+namespace RhAL
+{
+DeviceGroup::DeviceGroup(const std::vector<id_t>& ids, const std::vector<TypedRegisterFloat*>& regs)
+  : _ids(ids)
+  , _regs(regs)
+  , _addr(0)
+  , _length(0)
+  , _buffer()
+  , _bufferSend()
+  , _isPending()
+  , _sendIds()
+  , _sendDatas()
+  , _sendStates()
+  , _needWrite(false)
+  , _mutex()
+{
+  if (_ids.size() == 0 || _ids.size() != _regs.size())
+  {
+    throw std::logic_error("DeviceGroup invalid devices");
+  }
+  _addr = _regs.front()->addr;
+  _length = _regs.front()->length;
+  for (size_t i = 0; i < _regs.size(); i++)
+  {
+    if (_regs[i]->isReadOnly)
+    {
+      throw std::logic_error("DeviceGroup read only register: " + _regs[i]->name);
+    }
+    if (_regs[i]->addr != _addr || _regs[i]->length != _length)
+    {
+      throw std::logic_error("DeviceGroup incompatible register on device id: " + std::to_string(_ids[i]));
+    }
+  }
+  _buffer.resize(_ids.size() * _length, 0);
+  _bufferSend.resize(_ids.size() * _length, 0);
+  _isPending.resize(_ids.size(), false);
+  _sendIds.reserve(_ids.size());
+  _sendDatas.reserve(_ids.size());
+  _sendStates.reserve(_ids.size());
+}
+
+size_t DeviceGroup::size() const
+{
+  return _ids.size();
+}
+const std::vector<id_t>& DeviceGroup::ids() const
+{
+  return _ids;
+}
+
+void DeviceGroup::writeValues(const float* values)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (size_t i = 0; i < _regs.size(); i++)
+  {
+    _regs[i]->funcConvEncode(_buffer.data() + i * _length, values[i]);
+    _isPending[i] = true;
+  }
+  _needWrite = true;
+}
+void DeviceGroup::writeValues(const std::vector<float>& values)
+{
+  if (values.size() != _ids.size())
+  {
+    throw std::logic_error("DeviceGroup invalid values size: " + std::to_string(values.size()));
+  }
+  writeValues(values.data());
+}
+
+bool DeviceGroup::needWrite() const
+{
+  return _needWrite;
+}
+
+}  // namespace RhAL
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "types.h"
+#include "Register.hpp"
+#include "Protocol/Protocol.hpp"
+
+namespace RhAL
+{
+/**
+ * DeviceGroup
+ *
+ * Fixed ordered set of Devices whose float
+ * Registers with a same name are written
+ * together from a contiguous array of values.
+ * Values are encoded in the group buffer and
+ * sent by the Manager as a single sync write at
+ * next flush (values of quarantined or busy
+ * Devices are kept until they are readmitted). Registers typed write value,
+ * aggregation and write callback are bypassed.
+ * (Created by BaseManager::addDeviceGroup())
+ */
+class DeviceGroup
+{
+public:
+  /**
+   * Initialization with the group Devices id
+   * and their Register (same address and length).
+   * Throw std::logic_error if Registers are not
+   * compatible or read only.
+   */
+  DeviceGroup(const std::vector<id_t>& ids, const std::vector<TypedRegisterFloat*>& regs);
+
+  /**
+   * Return the number of Devices
+   * and their ids in group order
+   */
+  size_t size() const;
+  const std::vector<id_t>& ids() const;
+
+  /**
+   * Encode given values (one per Device in group
+   * order) and mark the group to be written at
+   * next flush. Values not yet sent are replaced.
+   * Throw std::logic_error if the vector size
+   * does not match the group size.
+   */
+  void writeValues(const float* values);
+  void writeValues(const std::vector<float>& values);
+
+  /**
+   * Return true if the group has
+   * values waiting to be written
+   */
+  bool needWrite() const;
+
+private:
+  /**
+   * Devices id and Registers
+   * in group order
+   */
+  std::vector<id_t> _ids;
+  std::vector<TypedRegisterFloat*> _regs;
+
+  /**
+   * Common Register address and length
+   */
+  addr_t _addr;
+  size_t _length;
+
+  /**
+   * Encoded values written by users
+   * and copy being sent by the Manager
+   * (length bytes per Device)
+   */
+  std::vector<data_t> _buffer;
+  std::vector<data_t> _bufferSend;
+
+  /**
+   * Per Device flag set when a value
+   * is waiting to be sent
+   */
+  std::vector<bool> _isPending;
+
+  /**
+   * Ids, data pointers and response
+   * states of the Devices actually sent
+   * (Manager thread only)
+   */
+  std::vector<id_t> _sendIds;
+  std::vector<const data_t*> _sendDatas;
+  std::vector<ResponseState> _sendStates;
+
+  /**
+   * Dirty flag
+   */
+  std::atomic<bool> _needWrite;
+
+  /**
+   * Mutex protecting the user buffer
+   */
+  mutable std::mutex _mutex;
+
+  /**
+   * Manager has access to
+   * private members
+   */
+  friend class BaseManager;
+};
+
+}  // namespace RhAL
@@ -0,0 +1,54 @@
+#include "DirtySet.hpp"
+
+namespace RhAL
+{
+DirtySet::DirtySet() : _size(0), _words()
+{
+}
+
+void DirtySet::resize(size_t size)
+{
+  size_t count = (size + 63) / 64;
+  _size = size;
+  _words.reset(new std::atomic<uint64_t>[count]);
+  for (size_t i = 0; i < count; i++)
+  {
+    _words[i].store(0);
+  }
+}
+
+size_t DirtySet::size() const
+{
+  return _size;
+}
+
+void DirtySet::insert(size_t index)
+{
+  if (index >= _size)
+  {
+    return;
+  }
+  _words[index / 64].fetch_or((uint64_t)1 << (index % 64), std::memory_order_acq_rel);
+}
+
+void DirtySet::extract(std::vector<size_t>& indexes)
+{
+  size_t count = (_size + 63) / 64;
+  for (size_t i = 0; i < count; i++)
+  {
+    // Avoid read modify write
+    // operations on empty words
+    if (_words[i].load(std::memory_order_relaxed) == 0)
+    {
+      continue;
+    }
+    uint64_t bits = _words[i].exchange(0, std::memory_order_acq_rel);
+    while (bits != 0)
+    {
+      indexes.push_back(i * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+}
+
+}  // namespace RhAL
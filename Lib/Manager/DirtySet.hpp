@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace RhAL
+{
+/**
+ * DirtySet
+ *
+ * Set of indexes in [0:size[ stored as
+ * a bitset of atomic words.
+ * Insertion is lock free and can be done
+ * from any thread. Extraction is done by
+ * a single consumer thread at a time.
+ */
+class DirtySet
+{
+public:
+  /**
+   * Initialization with zero size
+   */
+  DirtySet();
+
+  /**
+   * Reset the set capacity to given
+   * size and remove all indexes.
+   * (Not thread safe)
+   */
+  void resize(size_t size);
+
+  /**
+   * Return the set capacity
+   */
+  size_t size() const;
+
+  /**
+   * Insert given index.
+   * Out of range indexes are ignored.
+   * (Lock free)
+   */
+  void insert(size_t index);
+
+  /**
+   * Append all contained indexes in
+   * increasing order to given container
+   * and remove them from the set.
+   * Cost is proportional to the number
+   * of words and extracted indexes.
+   */
+  void extract(std::vector<size_t>& indexes);
+
+private:
+  /**
+   * Capacity and bitset words
+   */
+  size_t _size;
+  std::unique_ptr<std::atomic<uint64_t>[]> _words;
+};
+
+}  // namespace RhAL
@@ -66,7 +66,11 @@ public:
     // Reset low level communication (bus/protocol)
     this->initBus();
     // Load specific Protocol parameters
-    this->protocolParametersList().loadJSON(j["Protocol"]);
+    // (shared by all buses)
+    for (size_t i = 0; i < this->busCount(); i++)
+    {
+      this->protocolParametersList(i).loadJSON(j["Protocol"]);
+    }
   }
 
   /**
@@ -134,6 +138,8 @@ public:
    * An optional callback function can
    * be given and will be called at each
    * Manager cycle.
+   * If the schedulerFrequency parameter is set,
+   * cycles start at fixed rate (see setSchedulerConfig()).
    */
   inline void startManagerThread(std::function<void()> callback = []() {})
   {
@@ -141,10 +147,13 @@ public:
     {
       _managerThreadContinue = true;
       _managerThread = new std::thread([this, callback]() {
+        this->schedulerSetupThread();
+        TimePoint deadline = getTimePoint();
         while (this->_managerThreadContinue)
         {
           this->flush(false);
           callback();
+          this->schedulerWaitNextPeriod(deadline);
         }
       });
     }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <limits>
 #include "Register.hpp"
 #include "CallManager.hpp"
 
@@ -17,15 +19,25 @@ Register::Register(const std::string& name, addr_t addr, size_t length, unsigned
   , isReadOnly(isReadOnly)
   , _dataBufferRead(nullptr)
   , _dataBufferWrite(nullptr)
-  , _lastDevReadUser()
+  , _lastDevReadUser(TimePoint().time_since_epoch().count())
   , _lastDevReadManager()
   , _lastUserWrite()
   , _needRead(false)
   , _needWrite(false)
   , _needSwaping(false)
   , _isLastReadError(true)
+  , _readSequence(0)
   , _isLastWriteError(false)
+  , _priority(PriorityNormal)
+  , _deferredCount(0)
+  , _readPeriod(periodPackedRead)
+  , _isBackgroundRead(false)
+  , _asyncWritesQueued()
+  , _asyncWritesSelected()
+  , _isAsyncWritePending(false)
+  , _isAsyncReadPending(false)
   , _manager(nullptr)
+  , _managerIndex(std::numeric_limits<size_t>::max())
   , _mutex()
 {
   if (length > MaxRegisterLength)
@@ -73,72 +85,178 @@ void Register::forceWrite()
 
 void Register::askRead()
 {
-  std::lock_guard<std::mutex> lock(_mutex);
   _needRead = true;
+  if (_manager != nullptr)
+  {
+    _manager->markNeedRead(_managerIndex);
+  }
 }
 void Register::askWrite()
 {
-  std::lock_guard<std::mutex> lock(_mutex);
   _needWrite = true;
+  if (_manager != nullptr)
+  {
+    _manager->markNeedWrite(_managerIndex);
+  }
 }
 
 bool Register::needRead() const
 {
-  std::lock_guard<std::mutex> lock(_mutex);
   return _needRead;
 }
 bool Register::needWrite() const
 {
-  std::lock_guard<std::mutex> lock(_mutex);
   return _needWrite;
 }
 
+void Register::setPriority(RegisterPriority priority)
+{
+  _priority = priority;
+}
+RegisterPriority Register::priority() const
+{
+  return _priority;
+}
+
+unsigned int Register::readPeriod() const
+{
+  return _readPeriod;
+}
+
 void Register::selectForWrite()
 {
   std::lock_guard<std::mutex> lock(_mutex);
   doConvEncode();
   _needWrite = false;
   _isLastWriteError = false;
+  // Queued asynchronous writes wait
+  // for this value to be issued
+  if (_isAsyncWritePending)
+  {
+    _asyncWritesSelected.insert(_asyncWritesSelected.end(), _asyncWritesQueued.begin(), _asyncWritesQueued.end());
+    _asyncWritesQueued.clear();
+  }
+}
+
+void Register::finishWrite(bool isSuccess)
+{
+  if (!_isAsyncWritePending)
+  {
+    return;
+  }
+  std::vector<std::function<void(bool)>> completions;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    completions.swap(_asyncWritesSelected);
+    _isAsyncWritePending = !_asyncWritesQueued.empty();
+  }
+  for (size_t i = 0; i < completions.size(); i++)
+  {
+    completions[i](isSuccess);
+  }
 }
 
 void Register::readyForRead()
 {
-  std::lock_guard<std::mutex> lock(_mutex);
   _needRead = false;
+  _deferredCount = 0;
+}
+
+void Register::deferRead()
+{
+  _deferredCount++;
+  askRead();
 }
 
 void Register::finishRead(TimePoint timestamp)
 {
   std::lock_guard<std::mutex> lock(_mutex);
-  _needSwaping = true;
   _lastDevReadManager = timestamp;
+  _needSwaping = true;
+  if (_manager != nullptr)
+  {
+    _manager->markNeedSwap(_managerIndex);
+  }
 }
 
 void Register::readError()
 {
-  std::lock_guard<std::mutex> lock(_mutex);
-  _isLastReadError = true;
-  _needRead = true;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    beginReadUpdate();
+    _isLastReadError.store(true, std::memory_order_relaxed);
+    endReadUpdate();
+    askRead();
+  }
+  if (_isAsyncReadPending)
+  {
+    doCompleteAsyncReads(true);
+  }
+}
+
+void Register::cancelAsyncReads()
+{
+  if (_isAsyncReadPending)
+  {
+    doCompleteAsyncReads(true);
+  }
+}
+
+RegisterPriority Register::agedPriority(unsigned int aging) const
+{
+  RegisterPriority priority = _priority;
+  unsigned int promotion = _deferredCount / std::max(aging, 1u);
+  if (promotion >= (unsigned int)priority)
+  {
+    return PriorityHigh;
+  }
+  return (RegisterPriority)(priority - promotion);
 }
 
 void Register::writeError()
 {
   std::lock_guard<std::mutex> lock(_mutex);
-  _needWrite = true;
   _isLastWriteError = true;
+  askWrite();
 }
 
 void Register::swapRead()
 {
-  std::lock_guard<std::mutex> lock(_mutex);
+  // Most registers have nothing
+  // to swap, avoid locking them
+  if (!_needSwaping)
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(_mutex);
   if (!_needSwaping)
   {
     return;
   }
   _needSwaping = false;
-  _isLastReadError = false;
+  beginReadUpdate();
+  _isLastReadError.store(false, std::memory_order_relaxed);
   doConvDecode();
-  _lastDevReadUser = _lastDevReadManager;
+  _lastDevReadUser.store(_lastDevReadManager.time_since_epoch().count(), std::memory_order_relaxed);
+  endReadUpdate();
+  doCallbackRead();
+  lock.unlock();
+  if (_isAsyncReadPending)
+  {
+    doCompleteAsyncReads(false);
+  }
+}
+
+void Register::beginReadUpdate()
+{
+  // Odd sequence, then release fence so that
+  // readers seeing new data see the odd sequence
+  _readSequence.store(_readSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+void Register::endReadUpdate()
+{
+  _readSequence.store(_readSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
 }
 
 template <typename T>
@@ -152,7 +270,7 @@ TypedRegister<T>::TypedRegister(const std::string& name, addr_t addr, size_t len
   , _minValue(T(0))
   , _maxValue(T(0))
   , _stepValue(T(0))
-  , _valueRead()
+  , _valueRead(T())
   , _valueWrite()
   , _aggregationPolicy(AggregateLast)
   , _callbackOnRead([](T val) { (void)val; })
@@ -170,7 +288,7 @@ TypedRegister<T>::TypedRegister(const std::string& name, addr_t addr, size_t len
   , _minValue(T(0))
   , _maxValue(T(0))
   , _stepValue(T(0))
-  , _valueRead()
+  , _valueRead(T())
   , _valueWrite()
   , _aggregationPolicy(AggregateLast)
   , _callbackOnRead([](T val) { (void)val; })
@@ -241,17 +359,111 @@ ReadValue<T> TypedRegister<T>::readValue()
 {
   // Do immediate read on the bus
   // is the register is configured to forceWrite
+  // (and not read in background)
   // or given Manager send mode
-  if (isForceRead || !_manager->isScheduleMode())
+  if ((isForceRead && !_isBackgroundRead) || !_manager->isScheduleMode())
   {
     forceRead();
   }
-  std::lock_guard<std::mutex> lock(_mutex);
-  return ReadValue<T>(_lastDevReadUser, _valueRead, _isLastReadError);
+  return lastReadValue();
+}
+
+template <typename T>
+ReadValue<T> TypedRegister<T>::lastReadValue() const
+{
+  // Sequence lock read, retried if the
+  // Manager has updated the value meanwhile
+  while (true)
+  {
+    unsigned int sequence = _readSequence.load(std::memory_order_acquire);
+    TimePoint::rep timestamp = _lastDevReadUser.load(std::memory_order_relaxed);
+    T value = _valueRead.load(std::memory_order_relaxed);
+    bool isError = _isLastReadError.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((sequence & 1) == 0 && sequence == _readSequence.load(std::memory_order_relaxed))
+    {
+      return ReadValue<T>(TimePoint(TimePoint::duration(timestamp)), value, isError);
+    }
+  }
+}
+
+template <typename T>
+std::future<ReadValue<T>> TypedRegister<T>::readAsync()
+{
+  std::shared_ptr<std::promise<ReadValue<T>>> promise = std::make_shared<std::promise<ReadValue<T>>>();
+  std::future<ReadValue<T>> future = promise->get_future();
+  readAsync([promise](ReadValue<T> value) { promise->set_value(value); });
+  return future;
+}
+template <typename T>
+void TypedRegister<T>::readAsync(std::function<void(ReadValue<T>)> callback)
+{
+  // Immediate read if no
+  // Manager flush is expected
+  if (!_manager->isScheduleMode())
+  {
+    forceRead();
+    callback(lastReadValue());
+    return;
+  }
+  // Devices never read can
+  // not complete the request
+  if (_manager->isDeviceDontRead(id))
+  {
+    ReadValue<T> value = lastReadValue();
+    callback(ReadValue<T>(value.timestamp, value.value, true));
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _asyncReads.push_back({ getTimePoint(), callback });
+    _isAsyncReadPending = true;
+  }
+  askRead();
+}
+
+template <typename T>
+std::future<bool> TypedRegister<T>::writeAsync(T val)
+{
+  std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  writeAsync(val, [promise](bool isSuccess) { promise->set_value(isSuccess); });
+  return future;
+}
+template <typename T>
+void TypedRegister<T>::writeAsync(T val, std::function<void(bool)> callback)
+{
+  // Immediate write if no
+  // Manager flush is expected
+  if (!_manager->isScheduleMode())
+  {
+    writeValue(val);
+    bool isError;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      isError = _isLastWriteError;
+    }
+    callback(!isError);
+    return;
+  }
+  storeWriteValue(val, false, callback);
 }
 
 template <typename T>
 void TypedRegister<T>::writeValue(T val, bool noCallback)
+{
+  storeWriteValue(val, noCallback, std::function<void(bool)>());
+  // Do immediate write on the bus
+  // is the register is configured to forceWrite
+  // or given Manager send mode
+  if (isForceWrite || !_manager->isScheduleMode())
+  {
+    forceWrite();
+  }
+}
+
+template <typename T>
+void TypedRegister<T>::storeWriteValue(T val, bool noCallback, std::function<void(bool)> completion)
 {
   // Check read only
   if (isReadOnly)
@@ -259,7 +471,7 @@ void TypedRegister<T>::writeValue(T val, bool noCallback)
     throw std::logic_error("TypedRegister write to read only Register: " + name);
   }
 
-  std::unique_lock<std::mutex> lock(_mutex);
+  std::lock_guard<std::mutex> lock(_mutex);
 
   // Compute aggregation if the value
   // has already been written and this is not
@@ -276,21 +488,18 @@ void TypedRegister<T>::writeValue(T val, bool noCallback)
   // Assign the timestamp
   _lastUserWrite = getTimePoint();
   // Mark as dirty
-  _needWrite = true;
+  askWrite();
+  // Queue the completion
+  if (completion)
+  {
+    _asyncWritesQueued.push_back(completion);
+    _isAsyncWritePending = true;
+  }
   // Call user callback
   if (!noCallback)
   {
     _callbackOnWrite(_valueWrite);
   }
-  // Unlock mutex
-  lock.unlock();
-  // Do immediate write on the bus
-  // is the register is configured to forceWrite
-  // or given Manager send mode
-  if (isForceWrite || !_manager->isScheduleMode())
-  {
-    forceWrite();
-  }
 }
 
 template <typename T>
@@ -341,9 +550,48 @@ void TypedRegister<T>::doConvEncode()
 template <typename T>
 void TypedRegister<T>::doConvDecode()
 {
-  _valueRead = funcConvDecode(_dataBufferRead);
-  // Call user callback
-  _callbackOnRead(_valueRead);
+  _valueRead.store(funcConvDecode(_dataBufferRead), std::memory_order_relaxed);
+}
+template <typename T>
+void TypedRegister<T>::doCallbackRead()
+{
+  _callbackOnRead(_valueRead.load(std::memory_order_relaxed));
+}
+template <typename T>
+void TypedRegister<T>::doCompleteAsyncReads(bool isError)
+{
+  // Select requests older than the read value
+  // (all of them on error). Others wait for
+  // the next read.
+  std::vector<AsyncRead> completions;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    TimePoint readDate = TimePoint(TimePoint::duration(_lastDevReadUser.load(std::memory_order_relaxed)));
+    size_t k = 0;
+    for (size_t i = 0; i < _asyncReads.size(); i++)
+    {
+      if (isError || _asyncReads[i].date <= readDate)
+      {
+        completions.push_back(_asyncReads[i]);
+      }
+      else
+      {
+        _asyncReads[k++] = _asyncReads[i];
+      }
+    }
+    _asyncReads.resize(k);
+    _isAsyncReadPending = (k > 0);
+  }
+  if (completions.size() == 0)
+  {
+    return;
+  }
+  ReadValue<T> last = lastReadValue();
+  ReadValue<T> value(last.timestamp, last.value, last.isError || isError);
+  for (size_t i = 0; i < completions.size(); i++)
+  {
+    completions[i].callback(value);
+  }
 }
 
 // Template explicite instantiation
@@ -3,6 +3,10 @@
 #include <functional>
 #include <stdexcept>
 #include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
 #include "types.h"
 #include "timestamp.h"
 #include "Aggregation.h"
@@ -71,10 +75,12 @@ public:
   const size_t length;
 
   /**
-   * Register Read period in flush cycle.
+   * Default Register Read period in flush cycle.
    * If 0, the register is not Read.
    * If 1, the register is Read every flush Read.
    * If n, the register is Real every n flush Read.
+   * (The Manager may override it from read
+   * subscriptions, see readPeriod())
    */
   const unsigned int periodPackedRead;
 
@@ -143,6 +149,21 @@ public:
   bool needRead() const;
   bool needWrite() const;
 
+  /**
+   * Set or return the register read priority
+   * class used when the Manager flush is time
+   * budgeted. Default is PriorityNormal.
+   */
+  void setPriority(RegisterPriority priority);
+  RegisterPriority priority() const;
+
+  /**
+   * Return the current Read period in flush
+   * cycle. It is periodPackedRead unless
+   * overridden by Manager read subscriptions.
+   */
+  unsigned int readPeriod() const;
+
 protected:
   /**
    * Raw data buffer pointer in
@@ -154,11 +175,12 @@ protected:
 
   /**
    * Timestamp of last hardware read from device.
-   * ReadUser is timestamp of current register typed value.
+   * ReadUser is timestamp of current register typed value
+   * (stored as ticks since epoch, see _readSequence).
    * ReadManager is timestamp of (possibly newer) data
    * in read buffer.
    */
-  TimePoint _lastDevReadUser;
+  std::atomic<TimePoint::rep> _lastDevReadUser;
   TimePoint _lastDevReadManager;
 
   /**
@@ -172,15 +194,15 @@ protected:
    * to be selected for Read or Write
    * on the bus.
    */
-  bool _needRead;
-  bool _needWrite;
+  std::atomic<bool> _needRead;
+  std::atomic<bool> _needWrite;
 
   /**
    * If true, the data in read buffer are newer
    * than current typed read value.
    * The Register has to be swap.
    */
-  bool _needSwaping;
+  std::atomic<bool> _needSwaping;
 
   /**
    * If true, the last read attempt
@@ -189,7 +211,16 @@ protected:
    * If false, the current user
    * read value has not been updated
    */
-  bool _isLastReadError;
+  std::atomic<bool> _isLastReadError;
+
+  /**
+   * Sequence lock of the user read state
+   * (typed read value, _lastDevReadUser and
+   * _isLastReadError). Odd while the Manager
+   * is updating it. Readers never lock and
+   * retry if the sequence has changed.
+   */
+  std::atomic<unsigned int> _readSequence;
 
   /**
    * If true, the last write attempt
@@ -199,12 +230,59 @@ protected:
    */
   bool _isLastWriteError;
 
+  /**
+   * Read priority class
+   */
+  std::atomic<RegisterPriority> _priority;
+
+  /**
+   * Number of consecutive flush cycles the
+   * read has been deferred by the Manager.
+   * Reset when the read is issued.
+   * (Manager thread only)
+   */
+  std::atomic<unsigned int> _deferredCount;
+
+  /**
+   * Current Read period in flush cycle
+   * (set by the Manager)
+   */
+  std::atomic<unsigned int> _readPeriod;
+
+  /**
+   * If true, the Register is read by the
+   * Manager in idle bus time and force read
+   * are no longer done on readValue()
+   * (set by the Manager)
+   */
+  std::atomic<bool> _isBackgroundRead;
+
+  /**
+   * Asynchronous write completions. Queued ones
+   * wait for the next write selection, selected
+   * ones for the end of the issued write.
+   * Pending flags are true if completions are
+   * waiting (read ones are held by TypedRegister).
+   * (Protected by _mutex)
+   */
+  std::vector<std::function<void(bool)>> _asyncWritesQueued;
+  std::vector<std::function<void(bool)>> _asyncWritesSelected;
+  std::atomic<bool> _isAsyncWritePending;
+  std::atomic<bool> _isAsyncReadPending;
+
   /**
    * Pointer to a base class
    * used to call the main manager
    */
   CallManager* _manager;
 
+  /**
+   * Index of the Register in Manager sorted
+   * Registers used to mark it as dirty.
+   * (Set by the Manager)
+   */
+  size_t _managerIndex;
+
   /**
    * Mutex protecting Register member
    */
@@ -219,6 +297,27 @@ protected:
   virtual void doConvEncode() = 0;
   virtual void doConvDecode() = 0;
 
+  /**
+   * Call the user read callback
+   * with current typed read value
+   */
+  virtual void doCallbackRead() = 0;
+
+  /**
+   * Complete the asynchronous reads waiting
+   * for the current read value. If isError is
+   * true, all are completed with the error.
+   * (No lock has to be held)
+   */
+  virtual void doCompleteAsyncReads(bool isError) = 0;
+
+  /**
+   * Begin and end an update of the user read
+   * state by the writer holding _mutex
+   */
+  void beginReadUpdate();
+  void endReadUpdate();
+
   /**
    * Manager has access to
    * private members
@@ -241,6 +340,22 @@ protected:
    */
   void readyForRead();
 
+  /**
+   * Mark the register read as deferred
+   * to next flush by the Manager time budget.
+   * Re mark the register to be read again.
+   * (Call by Manager)
+   */
+  void deferRead();
+
+  /**
+   * Return the read priority class promoted
+   * by one class every given number of
+   * consecutive deferred reads (aging).
+   * (Call by Manager)
+   */
+  RegisterPriority agedPriority(unsigned int aging) const;
+
   /**
    * Mark the register as read end and need
    * swapping.
@@ -257,6 +372,14 @@ protected:
    */
   void readError();
 
+  /**
+   * Complete the pending asynchronous
+   * reads with the read error
+   * (Call by Manager when the Device
+   * is excluded from reads)
+   */
+  void cancelAsyncReads();
+
   /**
    * Mark the register as last write
    * operatio failed.
@@ -265,6 +388,14 @@ protected:
    */
   void writeError();
 
+  /**
+   * Mark the register selected write as
+   * issued on the bus and complete the waiting
+   * asynchronous writes with given result.
+   * (Call by Manager)
+   */
+  void finishWrite(bool isSuccess);
+
   /**
    * If the register swap is needed,
    * convert the read data buffer into
@@ -351,9 +482,48 @@ public:
    * Return the last read value from
    * the hardware. The returned timestamp
    * is the time when data are received from the bus.
+   * Lock free, never waits for the Manager.
    */
   ReadValue<T> readValue();
 
+  /**
+   * Return the last read value as readValue()
+   * but never read the bus (even for force read
+   * Register or in immediate mode)
+   */
+  ReadValue<T> lastReadValue() const;
+
+  /**
+   * Ask the read of the register at next
+   * Manager flush without blocking (even for
+   * force read Register). The returned future
+   * or given callback is completed with the
+   * first value read after the call or with
+   * the read error (at once if the Device
+   * is not read, at next flush if it is
+   * quarantined or busy). Callbacks are called
+   * by the Manager thread and must not block
+   * nor force bus operations.
+   * In immediate mode (no schedule), the read
+   * is done and completed before returning.
+   */
+  std::future<ReadValue<T>> readAsync();
+  void readAsync(std::function<void(ReadValue<T>)> callback);
+
+  /**
+   * Set the current contained typed value as
+   * writeValue() but write it at next Manager
+   * flush without blocking (even for force write
+   * Register). The returned future or given callback
+   * is completed with the write success once it
+   * has been issued on the bus (callbacks as
+   * for readAsync()).
+   * In immediate mode (no schedule), the write
+   * is done and completed before returning.
+   */
+  std::future<bool> writeAsync(T val);
+  void writeAsync(T val, std::function<void(bool)> callback);
+
   /**
    * Set the current contained typed value.
    * If the register is written multiple times
@@ -397,8 +567,21 @@ protected:
    */
   virtual void doConvEncode() override;
   virtual void doConvDecode() override;
+  virtual void doCallbackRead() override;
+  virtual void doCompleteAsyncReads(bool isError) override;
 
 private:
+  /**
+   * Internal structure for an
+   * asynchronous read request
+   */
+  struct AsyncRead
+  {
+    // Request date
+    TimePoint date;
+    // Completion callback
+    std::function<void(ReadValue<T>)> callback;
+  };
   /**
    * Additional optional range values and minimum
    * step value for the register.
@@ -417,8 +600,9 @@ private:
    * ValueRead is the current hardware
    * register read value. Possible newer value
    * is in data read buffer waiting for swapping.
+   * ValueRead is read without lock.
    */
-  T _valueRead;
+  std::atomic<T> _valueRead;
   T _valueWrite;
 
   /**
@@ -435,6 +619,21 @@ private:
    */
   std::function<void(T)> _callbackOnRead;
   std::function<void(T)> _callbackOnWrite;
+
+  /**
+   * Asynchronous reads waiting for
+   * a read value newer than their request
+   * (Protected by _mutex)
+   */
+  std::vector<AsyncRead> _asyncReads;
+
+  /**
+   * Set the typed written value and mark the
+   * register to be written, see writeValue().
+   * If given, the completion is queued for
+   * the next write of the value.
+   */
+  void storeWriteValue(T val, bool noCallback, std::function<void(bool)> completion);
 };
 
 /**
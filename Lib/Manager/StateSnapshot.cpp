@@ -0,0 +1,51 @@
+#include <stdexcept>
+#include "StateSnapshot.hpp"
+
+namespace RhAL
+{
+StateSnapshot::StateSnapshot() : cycle(0), date(), ids(), names(), values(), timestamps(), errors()
+{
+}
+
+size_t StateSnapshot::column(const std::string& name) const
+{
+  for (size_t k = 0; k < names.size(); k++)
+  {
+    if (names[k] == name)
+    {
+      return k;
+    }
+  }
+  throw std::logic_error("StateSnapshot register not found: " + name);
+}
+size_t StateSnapshot::index(id_t id) const
+{
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    if (ids[i] == id)
+    {
+      return i;
+    }
+  }
+  throw std::logic_error("StateSnapshot device id not found: " + std::to_string(id));
+}
+
+const float* StateSnapshot::columnValues(size_t column) const
+{
+  return values.data() + column * ids.size();
+}
+const TimePoint* StateSnapshot::columnTimestamps(size_t column) const
+{
+  return timestamps.data() + column * ids.size();
+}
+const uint8_t* StateSnapshot::columnErrors(size_t column) const
+{
+  return errors.data() + column * ids.size();
+}
+
+float StateSnapshot::value(const std::string& name, id_t id) const
+{
+  return columnValues(column(name))[index(id)];
+}
+
+}  // namespace RhAL
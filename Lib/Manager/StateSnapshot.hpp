@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "types.h"
+
+namespace RhAL
+{
+/**
+ * StateSnapshot
+ *
+ * Immutable copy of a set of float Registers
+ * of all Devices taken at a same Manager swap.
+ * Values are stored as structure of arrays:
+ * one contiguous column per Register name
+ * indexed by Device index (Devices sorted by id).
+ */
+struct StateSnapshot
+{
+  // Read cycle and date
+  // of the publication
+  unsigned long cycle;
+  TimePoint date;
+  // Devices id for
+  // each Device index
+  std::vector<id_t> ids;
+  // Register name
+  // for each column
+  std::vector<std::string> names;
+  // Read values, timestamps and error flags
+  // stored column after column. Devices without
+  // the Register have NaN value and error set.
+  std::vector<float> values;
+  std::vector<TimePoint> timestamps;
+  std::vector<uint8_t> errors;
+
+  /**
+   * Initialization with no column
+   */
+  StateSnapshot();
+
+  /**
+   * Return the column index of given Register
+   * name or the Device index of given id.
+   * Throw std::logic_error if not found.
+   */
+  size_t column(const std::string& name) const;
+  size_t index(id_t id) const;
+
+  /**
+   * Return pointers to the contiguous
+   * values, timestamps and error flags
+   * of given column (ids.size() elements)
+   */
+  const float* columnValues(size_t column) const;
+  const TimePoint* columnTimestamps(size_t column) const;
+  const uint8_t* columnErrors(size_t column) const;
+
+  /**
+   * Return the value of given
+   * Register name and Device id
+   */
+  float value(const std::string& name, id_t id) const;
+};
+
+}  // namespace RhAL
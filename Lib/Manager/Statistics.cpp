@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Statistics.hpp"
 #include "timestamp.h"
 
@@ -24,6 +25,15 @@ void Statistics::reset()
   writeLength = 0;
   syncReadLength = 0;
   syncWriteLength = 0;
+  bulkReadCount = 0;
+  bulkWriteCount = 0;
+  bulkReadLength = 0;
+  bulkWriteLength = 0;
+  sumBulkReadDuration = TimeDurationMicro(0);
+  sumBulkWriteDuration = TimeDurationMicro(0);
+  maxBulkReadDuration = TimeDurationMicro(0);
+  maxBulkWriteDuration = TimeDurationMicro(0);
+  gapReadLength = 0;
   sumReadDuration = TimeDurationMicro(0);
   sumWriteDuration = TimeDurationMicro(0);
   sumSyncReadDuration = TimeDurationMicro(0);
@@ -37,11 +47,18 @@ void Statistics::reset()
   waitNextFlushCooperativeCount = 0;
   forceReadCount = 0;
   forceWriteCount = 0;
+  forceCoalescedCount = 0;
   waitUsersDuration = TimeDurationMicro(0);
   waitManagerDuration = TimeDurationMicro(0);
   lastFlushTimePoint = TimePoint();
   maxFlushPeriod = TimeDurationMicro(0);
   sumFlushPeriod = TimeDurationMicro(0);
+  schedulerPeriodCount = 0;
+  schedulerDeadlineMissCount = 0;
+  schedulerJitterHistogram.fill(0);
+  maxSchedulerJitter = TimeDurationMicro(0);
+  readDeferredCount.fill(0);
+  flushBudgetOverrunCount = 0;
   emergencyCount = 0;
   exitEmergencyCount = 0;
   deviceOKCount = 0;
@@ -49,6 +66,46 @@ void Statistics::reset()
   deviceQuietCount = 0;
   deviceErrorCount = 0;
   writeErrorCount = 0;
+  deviceQuarantineCount = 0;
+  deviceReadmitCount = 0;
+  quarantineProbeCount = 0;
+  slowWriteCount = 0;
+  slowWriteProbeReleaseCount = 0;
+  sumDeviceBusyDuration = TimeDurationMicro(0);
+  maxDeviceBusyDuration = TimeDurationMicro(0);
+  backgroundReadCount = 0;
+  backgroundReadLength = 0;
+  backgroundReadErrorCount = 0;
+  deviceGroupWriteCount = 0;
+  batchPlanRebuildCount = 0;
+  batchPlanReuseCount = 0;
+  periodicReadLoad.clear();
+}
+
+double Statistics::schedulerJitterPercentile(double percentile) const
+{
+  unsigned long total = 0;
+  for (size_t i = 0; i < schedulerJitterHistogram.size(); i++)
+  {
+    total += schedulerJitterHistogram[i];
+  }
+  if (total == 0)
+  {
+    return 0.0;
+  }
+  // Smallest bucket reaching the
+  // requested rank
+  double rank = percentile * total;
+  unsigned long count = 0;
+  for (size_t i = 0; i < schedulerJitterHistogram.size(); i++)
+  {
+    count += schedulerJitterHistogram[i];
+    if (count >= rank && count > 0)
+    {
+      return i;
+    }
+  }
+  return schedulerJitterHistogram.size() - 1;
 }
 
 void Statistics::print(std::ostream& os) const
@@ -67,12 +124,24 @@ void Statistics::print(std::ostream& os) const
     os << "Mean Manager flush() period: " << duration_float(sumFlushPeriod) / (flushCount - 1.0) << "s" << std::endl;
   }
   os << "Max Manager flush() period: " << duration_float(maxFlushPeriod) << "s" << std::endl;
+  if (schedulerPeriodCount > 0)
+  {
+    os << "Scheduler periods: " << schedulerPeriodCount << std::endl;
+    os << "Scheduler missed deadlines: " << schedulerDeadlineMissCount << std::endl;
+    os << "Scheduler period jitter p50/p90/p99: " << schedulerJitterPercentile(0.5) << "us "
+       << schedulerJitterPercentile(0.9) << "us " << schedulerJitterPercentile(0.99) << "us" << std::endl;
+    os << "Scheduler period max jitter: " << duration_float(maxSchedulerJitter) << "s" << std::endl;
+  }
+  os << "Deferred reads high/normal/low priority: " << readDeferredCount[PriorityHigh] << " "
+     << readDeferredCount[PriorityNormal] << " " << readDeferredCount[PriorityLow] << std::endl;
+  os << "Flush budget overruns: " << flushBudgetOverrunCount << std::endl;
   os << "WaitNextFlush() cooperative calls: " << waitNextFlushCooperativeCount << std::endl;
   os << "WaitNextFlush() not cooperative calls: " << waitNextFlushCount << std::endl;
   os << "Waiting in flush() spent time: " << duration_float(waitUsersDuration) << "s" << std::endl;
   os << "Waiting in WaitNextFlush() spent time: " << duration_float(waitManagerDuration) << "s" << std::endl;
   os << "ForceRead() calls: " << forceReadCount << std::endl;
   os << "ForceWrite() calls: " << forceWriteCount << std::endl;
+  os << "ForceRead()/ForceWrite() coalesced calls: " << forceCoalescedCount << std::endl;
   os << "EmergencyStop() calls: " << emergencyCount << std::endl;
   os << "ExitEmergencyState() calls: " << exitEmergencyCount << std::endl;
   os << "Read() calls: " << readCount << std::endl;
@@ -107,11 +176,55 @@ void Statistics::print(std::ostream& os) const
     os << "SyncWrite() mean spent time: " << duration_float(sumSyncWriteDuration) / syncWriteCount << "s" << std::endl;
   }
   os << "SyncWrite() max spent time: " << duration_float(maxSyncWriteDuration) << "s" << std::endl;
+  os << "BulkRead() calls: " << bulkReadCount << std::endl;
+  os << "BulkRead() bytes length: " << bulkReadLength << std::endl;
+  os << "BulkRead() sum spent time: " << duration_float(sumBulkReadDuration) << "s" << std::endl;
+  if (bulkReadCount > 0)
+  {
+    os << "BulkRead() mean spent time: " << duration_float(sumBulkReadDuration) / bulkReadCount << "s" << std::endl;
+  }
+  os << "BulkRead() max spent time: " << duration_float(maxBulkReadDuration) << "s" << std::endl;
+  os << "BulkWrite() calls: " << bulkWriteCount << std::endl;
+  os << "BulkWrite() bytes length: " << bulkWriteLength << std::endl;
+  os << "BulkWrite() sum spent time: " << duration_float(sumBulkWriteDuration) << "s" << std::endl;
+  if (bulkWriteCount > 0)
+  {
+    os << "BulkWrite() mean spent time: " << duration_float(sumBulkWriteDuration) / bulkWriteCount << "s"
+       << std::endl;
+  }
+  os << "BulkWrite() max spent time: " << duration_float(maxBulkWriteDuration) << "s" << std::endl;
+  os << "Gap read unused bytes length: " << gapReadLength << std::endl;
   os << "Devices valid responses: " << deviceOKCount << std::endl;
   os << "Devices warning responses: " << deviceWarningCount << std::endl;
   os << "Devices quiet responses: " << deviceQuietCount << std::endl;
   os << "Devices error responses: " << deviceErrorCount << std::endl;
   os << "Detected write() errors count: " << writeErrorCount << std::endl;
+  os << "Devices put in quarantine: " << deviceQuarantineCount << std::endl;
+  os << "Devices readmitted: " << deviceReadmitCount << std::endl;
+  os << "Quarantine ping probes: " << quarantineProbeCount << std::endl;
+  os << "Slow register writes: " << slowWriteCount << std::endl;
+  os << "Slow register writes ended by probe: " << slowWriteProbeReleaseCount << std::endl;
+  os << "Slow register writes sum blocked time: " << duration_float(sumDeviceBusyDuration) << "s" << std::endl;
+  os << "Slow register writes max blocked time: " << duration_float(maxDeviceBusyDuration) << "s" << std::endl;
+  os << "Background reads: " << backgroundReadCount << std::endl;
+  os << "Background reads length: " << backgroundReadLength << std::endl;
+  os << "Background reads errors: " << backgroundReadErrorCount << std::endl;
+  os << "Device group writes: " << deviceGroupWriteCount << std::endl;
+  os << "Batch plans rebuilt: " << batchPlanRebuildCount << std::endl;
+  os << "Batch plans reused: " << batchPlanReuseCount << std::endl;
+  if (periodicReadLoad.size() > 0)
+  {
+    unsigned long maxLoad = 0;
+    unsigned long sumLoad = 0;
+    for (size_t i = 0; i < periodicReadLoad.size(); i++)
+    {
+      maxLoad = std::max(maxLoad, periodicReadLoad[i]);
+      sumLoad += periodicReadLoad[i];
+    }
+    os << "Periodic reads load per cycle max/mean: " << maxLoad << "/"
+       << (double)sumLoad / (double)periodicReadLoad.size() << " bytes over " << periodicReadLoad.size()
+       << " cycles" << std::endl;
+  }
 }
 
 }  // namespace RhAL
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <iostream>
+#include <vector>
 #include "types.h"
 
 namespace RhAL
@@ -36,6 +38,20 @@ struct Statistics
   unsigned long writeLength;
   unsigned long syncReadLength;
   unsigned long syncWriteLength;
+  // Number of calls, total data length, total
+  // and maximum time duration of Protocol
+  // bulkRead/bulkWrite calls
+  unsigned long bulkReadCount;
+  unsigned long bulkWriteCount;
+  unsigned long bulkReadLength;
+  unsigned long bulkWriteLength;
+  TimeDurationMicro sumBulkReadDuration;
+  TimeDurationMicro sumBulkWriteDuration;
+  TimeDurationMicro maxBulkReadDuration;
+  TimeDurationMicro maxBulkWriteDuration;
+  // Total length of unused data read between
+  // non contiguous registers (gap read)
+  unsigned long gapReadLength;
   // Total time duration spent during Protocol
   // read/write/syncRead/syncWrite calls
   // and maximum duration
@@ -54,6 +70,9 @@ struct Statistics
   unsigned long waitNextFlushCooperativeCount;
   unsigned long forceReadCount;
   unsigned long forceWriteCount;
+  // Number of forceRead() and forceWrite()
+  // calls coalesced into a sync operation
+  unsigned long forceCoalescedCount;
   // Total time duration spent during
   // Manager waiting for cooperative users
   // threads at flush() begining and
@@ -67,6 +86,22 @@ struct Statistics
   // two consecutives flush() call
   TimeDurationMicro maxFlushPeriod;
   TimeDurationMicro sumFlushPeriod;
+  // Fixed rate Manager thread scheduler:
+  // number of periods, number of missed
+  // deadlines and histogram of the period
+  // jitter (delay of each period start after
+  // its absolute deadline, clamped at zero)
+  // in microseconds
+  unsigned long schedulerPeriodCount;
+  unsigned long schedulerDeadlineMissCount;
+  std::array<unsigned long, SchedulerJitterBuckets> schedulerJitterHistogram;
+  TimeDurationMicro maxSchedulerJitter;
+  // Flush time budget: number of register
+  // reads deferred to a next flush for each
+  // priority class and number of flushes
+  // exceeding their budget
+  std::array<unsigned long, RegisterPriorityCount> readDeferredCount;
+  unsigned long flushBudgetOverrunCount;
   // Number of calls to Manager
   // emergencyStop(), exitEmergencyState()
   unsigned long emergencyCount;
@@ -81,6 +116,37 @@ struct Statistics
   unsigned long deviceErrorCount;
   // Number of detected write errors
   unsigned long writeErrorCount;
+  // Number of Devices put in quarantine,
+  // readmitted and of ping probes sent
+  // to quarantined Devices
+  unsigned long deviceQuarantineCount;
+  unsigned long deviceReadmitCount;
+  unsigned long quarantineProbeCount;
+  // Slow register (EEPROM) writes: number of
+  // write windows opened, windows ended early
+  // by a readiness probe and sum and max time
+  // Devices have been excluded from the bus
+  unsigned long slowWriteCount;
+  unsigned long slowWriteProbeReleaseCount;
+  TimeDurationMicro sumDeviceBusyDuration;
+  TimeDurationMicro maxDeviceBusyDuration;
+  // Number of background reads issued in
+  // scheduler idle time, total data length
+  // and number of failed background reads
+  unsigned long backgroundReadCount;
+  unsigned long backgroundReadLength;
+  unsigned long backgroundReadErrorCount;
+  // Number of Device groups
+  // ready made sync writes
+  unsigned long deviceGroupWriteCount;
+  // Number of read/write batch plans
+  // computed and reused from cache
+  unsigned long batchPlanRebuildCount;
+  unsigned long batchPlanReuseCount;
+  // Predicted bytes read by periodic registers
+  // at each cycle of the periodic reads schedule
+  // horizon (filled from the current schedule)
+  std::vector<unsigned long> periodicReadLoad;
 
   /**
    * Initialization
@@ -92,6 +158,14 @@ struct Statistics
    */
   void reset();
 
+  /**
+   * Return the given percentile (between 0 and 1)
+   * of the scheduler period jitter (start delay
+   * after the deadline) in microseconds
+   * (computed from the histogram)
+   */
+  double schedulerJitterPercentile(double percentile) const;
+
   /**
    * Display on given output stream the
    * textual statitics summary.
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <unistd.h>
 #include <thread>
+#include <algorithm>
 
 #define DEBUG 0
 using namespace std;
@@ -14,30 +15,23 @@ namespace RhAL
 {
 DynamixelV1::Packet::Packet(id_t id, DynamixelV1Command instruction, size_t parameters_)
 {
-  position = 0;
-  parameters = parameters_;
-
-  buffer = new uint8_t[getSize()];
-  buffer[2] = id;
-  buffer[3] = parameters + 2;
+  reset(id, parameters_);
   buffer[4] = instruction;
 }
 
-DynamixelV1::Packet::Packet(id_t id, size_t parameters_)
+void DynamixelV1::Packet::reset(id_t id, size_t parameters_)
 {
+  if (parameters_ > MaxParameters)
+  {
+    throw logic_error("DynamixelV1 packet too large: " + std::to_string(parameters_));
+  }
   position = 0;
   parameters = parameters_;
 
-  buffer = new uint8_t[getSize()];
   buffer[2] = id;
   buffer[3] = parameters + 2;
 }
 
-DynamixelV1::Packet::~Packet()
-{
-  delete[] buffer;
-}
-
 void DynamixelV1::Packet::append(uint8_t byte)
 {
   if (position < parameters)
@@ -74,16 +68,6 @@ void DynamixelV1::Packet::prepare()
   buffer[5 + parameters] = computeChecksum();
 }
 
-void DynamixelV1::Packet::setError(uint8_t error)
-{
-  buffer[4] = error;
-}
-
-uint8_t DynamixelV1::Packet::getError()
-{
-  return buffer[4];
-}
-
 size_t DynamixelV1::Packet::getSize()
 {
   // A packet is: Header (2), ID, length, instruction, parameters and checksum
@@ -95,7 +79,8 @@ uint8_t* DynamixelV1::Packet::getParameters()
   return buffer + 5;
 }
 
-DynamixelV1::DynamixelV1(Bus& bus) : Protocol(bus), _timeout("timeout", 0.01), _waitAfterWrite("waitAfterWrite", 0.0005)
+DynamixelV1::DynamixelV1(Bus& bus)
+  : Protocol(bus), _rxBegin(0), _rxEnd(0), _timeout("timeout", 0.01), _waitAfterWrite("waitAfterWrite", 0.0005)
 {
   _parametersList.add(&_timeout);
   _parametersList.add(&_waitAfterWrite);
@@ -106,9 +91,9 @@ void DynamixelV1::writeData(id_t id, addr_t address, const uint8_t* data, size_t
   Packet packet(id, CommandWrite, size + 1);
   packet.append(address);
   packet.append(data, size);
-  sendPacket(packet);
+  sendPacket(packet, false);
   // Can't talk to the servos too soon
-  std::this_thread::sleep_for(TimeDurationFloat(_waitAfterWrite.value));
+  waitAfterWrite(_waitAfterWrite.value);
 }
 
 /**
@@ -132,29 +117,22 @@ ResponseState DynamixelV1::sendAndReceiveData(DynamixelV1Command instruction, id
   packet.append(size);
   sendPacket(packet);
 
-  Packet* response;
-  auto code = receivePacket(response, id);
+  const uint8_t* parameters;
+  size_t parametersSize;
+  auto code = receivePacket(id, parameters, parametersSize);
 #if DEBUG
-  if (response == NULL)
+  std::cout << "Receiving parameters : ";
+  for (size_t i = 0; (code & ResponseOK) && i < parametersSize; i++)
   {
-    std::cout << "Response null" << endl;
-  }
-  else
-  {
-    std::cout << "Receiving packet : ";
-    for (int i = 0; i < response->getSize(); i++)
-    {
-      std::cout << (int)response->buffer[i] << " ";
-    }
-    std::cout << ", code = " << (int)code << endl;
-    std::cout << std::endl;
+    std::cout << (int)parameters[i] << " ";
   }
+  std::cout << ", code = " << (int)code << endl;
+  std::cout << std::endl;
 #endif
 
   if (code & ResponseOK)
   {
-    memcpy(data, response->getParameters(), size);
-    delete response;
+    memcpy(data, parameters, std::min(size, parametersSize));
   }
   return code;
 }
@@ -164,11 +142,11 @@ bool DynamixelV1::ping(id_t id)
   Packet packet(id, CommandPing, 0);
   sendPacket(packet);
 
-  Packet* response;
-  auto code = receivePacket(response, id);
+  const uint8_t* parameters;
+  size_t parametersSize;
+  auto code = receivePacket(id, parameters, parametersSize);
   if (code & ResponseOK)
   {
-    delete response;
     return true;
   }
   else
@@ -177,100 +155,102 @@ bool DynamixelV1::ping(id_t id)
   }
 }
 
-std::vector<ResponseState> DynamixelV1::syncSendAndReceiveData(DynamixelV1Command instruction,
-                                                               const std::vector<id_t>& ids, addr_t address,
-                                                               const std::vector<uint8_t*>& datas, size_t size)
+void DynamixelV1::syncSendAndReceiveData(DynamixelV1Command instruction, const std::vector<id_t>& ids,
+                                         addr_t address, const std::vector<uint8_t*>& datas, size_t size,
+                                         std::vector<ResponseState>& states)
 {
-  // Here instruction is either CommandSyncRead or CommandSyncWriteAndCheck
-  Packet packet(0xfd, instruction, ids.size() + 2);  // Number of motor ids + starting address and size
-  // packet.buffer[3]=ids.size()+4;     //length has to be 4+(number of ids) but packet already adds 2 so we replace
-  // adress from where we start to read
-  packet.append(address);
-  // number of bytes to read
-  packet.append(size);
-  // ids
-  for (size_t i = 0; i < ids.size(); i++)
-    packet.append(ids[i]);
-
-  sendPacket(packet);
-
-  Packet* response;
-  auto code = receivePacket(response, 0xfd);
-#if DEBUG
-  if (response == NULL)
+  // The states container is reused
+  // between calls (no allocation)
+  states.resize(ids.size());
+  // Ids are split into balanced chunks
+  // fitting in a single frame
+  size_t count = syncChunksCount(ids.size(), size);
+  for (size_t chunk = 0; chunk < count; chunk++)
   {
-    std::cout << "Sync Response null" << endl;
-  }
-  else
-  {
-    std::cout << "Sync Receiving packet : ";
-    for (int i = 0; i < response->getSize(); i++)
+    size_t first = chunk * ids.size() / count;
+    size_t last = (chunk + 1) * ids.size() / count;
+    size_t n = last - first;
+
+    // Here instruction is either CommandSyncRead or CommandSyncWriteAndCheck
+    Packet packet(0xfd, instruction, n + 2);  // Number of motor ids + starting address and size
+    // packet.buffer[3]=ids.size()+4;     //length has to be 4+(number of ids) but packet already adds 2 so we replace
+    // adress from where we start to read
+    packet.append(address);
+    // number of bytes to read
+    packet.append(size);
+    // ids
+    for (size_t i = first; i < last; i++)
+      packet.append(ids[i]);
+
+    sendPacket(packet);
+
+    const uint8_t* parameters;
+    size_t parametersSize;
+    auto code = receivePacket(0xfd, parameters, parametersSize);
+#if DEBUG
+    std::cout << "Sync Receiving parameters : ";
+    for (size_t i = 0; (code & ResponseOK) && i < parametersSize; i++)
     {
-      std::cout << (int)response->buffer[i] << " ";
+      std::cout << (int)parameters[i] << " ";
     }
     std::cout << ", code = " << (int)code << endl;
     std::cout << std::endl;
-  }
 #endif
 
-  std::vector<ResponseState> ret;
-  // returns: ID LENGTH ERROR ERROR_0 PARAM_0_0 PARAM_0_1 ... PARAM_0_N ERROR_1 PARAM_1_0 ...
-  if (code & ResponseOK)
-  {
-    for (size_t i = 0; i < ids.size(); i++)
+    // A truncated response cannot be parsed
+    if ((code & ResponseOK) && parametersSize < n * (size + 1))
     {
-      // printf("MOTOR: %d data: %x %x
-      // %x\n",i,(uint8_t)*(response->getParameters()+i*(size+1)),(uint8_t)*(response->getParameters()+i*(size+1)+1),(uint8_t)*(response->getParameters()+i*(size+1)+2));
-      unsigned int error = *(response->getParameters() + i * (size + 1));  // first the motor error code
-      if (error == 0xFF)
-      {
-        ret.push_back(ResponseQuiet);  // motor timeout exceeded
-      }
-      else
+      code = ResponseBadSize;
+    }
+    // returns: ID LENGTH ERROR ERROR_0 PARAM_0_0 PARAM_0_1 ... PARAM_0_N ERROR_1 PARAM_1_0 ...
+    if (code & ResponseOK)
+    {
+      for (size_t i = 0; i < n; i++)
       {
-        if (error & ErrorChecksum)
-        {  // we should probably ignore the data...
-          ret.push_back(ResponseDeviceBadChecksum);
-        }
-        else if (error & ErrorInstruction)
+        unsigned int error = *(parameters + i * (size + 1));  // first the motor error code
+        if (error == 0xFF)
         {
-          ret.push_back(ResponseDeviceBadInstruction);
+          states[first + i] = ResponseQuiet;  // motor timeout exceeded
         }
         else
         {
-          unsigned int ecode = ResponseOK;  // humm not a very good use of flags, we miss some errors...
-          if (error & ErrorVoltage)
-            ecode |= ResponseBadVoltage;
-          if (error & ErrorOverheat)
-            ecode |= ResponseOverheat;
-          if (error & ErrorOverload)
-            ecode |= ResponseOverload;
-          ret.push_back(ecode);
+          if (error & ErrorChecksum)
+          {  // we should probably ignore the data...
+            states[first + i] = ResponseDeviceBadChecksum;
+          }
+          else if (error & ErrorInstruction)
+          {
+            states[first + i] = ResponseDeviceBadInstruction;
+          }
+          else
+          {
+            unsigned int ecode = ResponseOK;  // humm not a very good use of flags, we miss some errors...
+            if (error & ErrorVoltage)
+              ecode |= ResponseBadVoltage;
+            if (error & ErrorOverheat)
+              ecode |= ResponseOverheat;
+            if (error & ErrorOverload)
+              ecode |= ResponseOverload;
+            states[first + i] = ecode;
+          }
+
+          memcpy(datas[first + i], parameters + i * (size + 1) + 1, size);
         }
-
-        memcpy(datas[i], response->getParameters() + i * (size + 1) + 1, size);
       }
     }
-    delete response;
-    return ret;
-  }
-  else
-  {
-    // std::cout<<"SYNC_READ ERROR: "<<code<<std::endl;
-    for (size_t i = 0; i < ids.size(); i++)
-      ret.push_back(code);
-    delete response;
-
-    return ret;
+    else
+    {
+      // std::cout<<"SYNC_READ ERROR: "<<code<<std::endl;
+      for (size_t i = first; i < last; i++)
+        states[i] = code;
+    }
   }
-
-  return ret;  // should never happen
 }
 
-std::vector<ResponseState> DynamixelV1::syncRead(const std::vector<id_t>& ids, addr_t address,
-                                                 const std::vector<uint8_t*>& datas, size_t size)
+void DynamixelV1::syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas,
+                           size_t size, std::vector<ResponseState>& states)
 {
-  return syncSendAndReceiveData(CommandSyncRead, ids, address, datas, size);
+  syncSendAndReceiveData(CommandSyncRead, ids, address, datas, size, states);
 }
 
 void DynamixelV1::syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
@@ -281,25 +261,64 @@ void DynamixelV1::syncWrite(const std::vector<id_t>& ids, addr_t address, const
     throw runtime_error("ids and datas should have the same size() for syncWrite");
   }
 
-  size_t N = ids.size();
-  Packet packet(Broadcast, CommandSyncWrite, 2 + N * (size + 1));
-  packet.append(address);
-  packet.append(size);
-  for (size_t k = 0; k < N; k++)
+  // Ids are split into balanced chunks fitting in a
+  // single frame. Sync write is not acknowledged so
+  // chunks are queued and sent back to back.
+  size_t count = syncChunksCount(ids.size(), size);
+  bool isQueued = isPipelined();
+  setPipelined(true);
+  for (size_t chunk = 0; chunk < count; chunk++)
   {
-    packet.append(ids[k]);
-    packet.append(datas[k], size);
+    size_t first = chunk * ids.size() / count;
+    size_t last = (chunk + 1) * ids.size() / count;
+    Packet packet(Broadcast, CommandSyncWrite, 2 + (last - first) * (size + 1));
+    packet.append(address);
+    packet.append(size);
+    for (size_t k = first; k < last; k++)
+    {
+      packet.append(ids[k]);
+      packet.append(datas[k], size);
+    }
+    sendPacket(packet, false);
   }
-  sendPacket(packet);
+  setPipelined(isQueued);
   // Can't talk to the servos too soon
-  std::this_thread::sleep_for(TimeDurationFloat(_waitAfterWrite.value));
+  waitAfterWrite(_waitAfterWrite.value);
+}
+
+void DynamixelV1::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                    const std::vector<const uint8_t*>& datas, size_t size,
+                                    std::vector<ResponseState>& states)
+{
+  syncSendAndReceiveData(CommandSyncWriteAndCheck, ids, address,
+                         reinterpret_cast<const std::vector<uint8_t*>&>(datas), size, states);
+}
+
+size_t DynamixelV1::maxSyncIds(size_t size) const
+{
+  // Address and size parameters followed by
+  // id (and error) plus data for each device.
+  // Sync read responses are smaller.
+  return (MaxParameters - 2) / (size + 1);
 }
 
-std::vector<ResponseState> DynamixelV1::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
-                                                          const std::vector<const uint8_t*>& datas, size_t size)
+size_t DynamixelV1::syncChunksCount(size_t count, size_t size) const
 {
-  return syncSendAndReceiveData(CommandSyncWriteAndCheck, ids, address,
-                                reinterpret_cast<const std::vector<uint8_t*>&>(datas), size);
+  size_t maxIds = maxSyncIds(size);
+  if (maxIds == 0)
+  {
+    throw logic_error("DynamixelV1 sync data size too large: " + std::to_string(size));
+  }
+  return (count + maxIds - 1) / maxIds;
+}
+
+size_t DynamixelV1::transactionOverheadBytes() const
+{
+  // Read request: header (2), id, length, instruction,
+  // address, size and checksum.
+  // Status response: header (2), id, length,
+  // error and checksum.
+  return 8 + 6;
 }
 
 /**
@@ -340,9 +359,11 @@ void DynamixelV1::exitEmergencyState()
   std::this_thread::sleep_for(TimeDurationFloat(_waitAfterWrite.value));
 }
 
-void DynamixelV1::sendPacket(Packet& packet)
+void DynamixelV1::sendPacket(Packet& packet, bool isResponseExpected)
 {
-  bus.clearInputBuffer();
+  // Pending received bytes are outdated
+  _rxBegin = 0;
+  _rxEnd = 0;
   //    	bus.flushInput();
   packet.prepare();
 #if DEBUG
@@ -353,113 +374,134 @@ void DynamixelV1::sendPacket(Packet& packet)
   }
   std::cout << std::endl;
 #endif
-  bus.sendData(packet.buffer, packet.getSize());
-  bus.flush();
+  sendRequest(packet.buffer, packet.getSize(), isResponseExpected);
 }
 
-ResponseState DynamixelV1::receivePacket(Packet*& response, id_t id)
+ResponseState DynamixelV1::receivePacket(id_t id, const uint8_t*& parameters, size_t& size)
 {
   ResponseState error = ResponseQuiet;
-  response = NULL;
-  TimePoint start = getTimePoint();
-  size_t position = 0;
-  while (duration_float(start, getTimePoint()) <= _timeout.value)
+  bool isBadChecksum = false;
+  TimePoint deadline =
+      getTimePoint() + std::chrono::duration_cast<TimePoint::duration>(TimeDurationFloat(_timeout.value));
+  while (true)
   {
-    double t = _timeout.value - (duration_float(start, getTimePoint()));
-    if (bus.waitForData(t))
+    // Scan already received bytes for a complete
+    // frame. An incomplete frame candidate may be
+    // garbage looking like a header, so the scan
+    // goes on after it.
+    size_t scan = _rxBegin;
+    size_t pending = _rxEnd;
+    while (scan < _rxEnd)
     {
-      size_t n = bus.available();
-      uint8_t data[n];
-      bus.readData(data, n);
-      for (size_t k = 0; k < n; k++)
+      // Look for the first header byte
+      const uint8_t* found = static_cast<const uint8_t*>(memchr(_rxBuffer + scan, 0xff, _rxEnd - scan));
+      if (found == nullptr)
       {
-        uint8_t byte = data[k];
-        switch (position)
-        {
-          case 0:
-          case 1:
-            if (byte == 0xff)
-            {
-              position++;
-            }
-            else
-            {
-              position = 0;
-            }
-            break;
-          case 2:
-            if (byte == id)
-            {
-              position++;
-            }
-            else
-            {
-              error = ResponseBadId;
-              position = 0;
-            }
-            break;
-          case 3:
-            if (byte >= 2)
-            {
-              response = new Packet(id, byte - 2);
-              position++;
-            }
-            else
-            {
-              error = ResponseBadSize;
-              position = 0;
-            }
-            break;
-          case 4:
-            response->setError(byte);
-            position++;
-            break;
-          default:
-            if (position - 5 < response->parameters)
-            {
-              response->append(byte);
-            }
-            else
-            {
-              if (response->computeChecksum() == byte)
-              {
-                uint8_t error = response->getError();
-
-                if (error & ErrorChecksum)
-                {
-                  delete response;
-                  return ResponseDeviceBadChecksum;
-                }
-                else if (error & ErrorInstruction)
-                {
-                  delete response;
-                  return ResponseDeviceBadInstruction;
-                }
-                else
-                {
-                  unsigned int code = ResponseOK;
-                  if (error & ErrorVoltage)
-                    code |= ResponseBadVoltage;
-                  if (error & ErrorOverheat)
-                    code |= ResponseOverheat;
-                  if (error & ErrorOverload)
-                    code |= ResponseOverload;
-
-                  return code;
-                }
-              }
-              else
-              {
-                delete response;
-                return ResponseBadChecksum;
-              }
-            }
-            position++;
-        }
+        break;
+      }
+      size_t pos = found - _rxBuffer;
+      scan = pos + 1;
+      // Wait for header, id and length fields
+      if (pos + 4 > _rxEnd)
+      {
+        pending = std::min(pending, pos);
+        break;
+      }
+      if (_rxBuffer[pos + 1] != 0xff)
+      {
+        continue;
+      }
+      // Validate length before waiting
+      // for the whole frame
+      size_t length = _rxBuffer[pos + 3];
+      if (length < 2)
+      {
+        error = ResponseBadSize;
+        continue;
       }
+      size_t total = 4 + length;
+      if (pos + total > _rxEnd)
+      {
+        pending = std::min(pending, pos);
+        continue;
+      }
+      // Check the frame in place
+      const uint8_t* frame = _rxBuffer + pos;
+      uint8_t checksum = 0;
+      for (size_t k = 2; k < total - 1; k++)
+      {
+        checksum += frame[k];
+      }
+      if ((uint8_t)~checksum != frame[total - 1])
+      {
+        // Either a corrupted frame or garbage looking
+        // like a header. A valid frame may start
+        // inside, so scan again from next byte.
+        isBadChecksum = true;
+        continue;
+      }
+      // The frame is consumed
+      scan = pos + total;
+      if (frame[2] != id)
+      {
+        error = ResponseBadId;
+        continue;
+      }
+      _rxBegin = pos + total;
+      parameters = frame + 5;
+      size = length - 2;
+
+      uint8_t deviceError = frame[4];
+      if (deviceError & ErrorChecksum)
+      {
+        return ResponseDeviceBadChecksum;
+      }
+      else if (deviceError & ErrorInstruction)
+      {
+        return ResponseDeviceBadInstruction;
+      }
+      else
+      {
+        unsigned int code = ResponseOK;
+        if (deviceError & ErrorVoltage)
+          code |= ResponseBadVoltage;
+        if (deviceError & ErrorOverheat)
+          code |= ResponseOverheat;
+        if (deviceError & ErrorOverload)
+          code |= ResponseOverload;
+
+        return code;
+      }
+    }
+    // Scanned bytes are dropped except
+    // for the first incomplete frame
+    _rxBegin = pending;
+    bool isPending = (pending < _rxEnd);
+
+    // A corrupted frame was received and no
+    // other frame is pending
+    if (isBadChecksum && !isPending)
+    {
+      return ResponseBadChecksum;
+    }
+    // Wait for more data
+    TimePoint now = getTimePoint();
+    if (now >= deadline)
+    {
+      return error;
+    }
+    if (bus.waitForData(duration_float(now, deadline)))
+    {
+      // Move pending bytes to the buffer front
+      if (_rxBegin > 0)
+      {
+        memmove(_rxBuffer, _rxBuffer + _rxBegin, _rxEnd - _rxBegin);
+        _rxEnd -= _rxBegin;
+        _rxBegin = 0;
+      }
+      size_t n = std::min(bus.available(), RxBufferSize - _rxEnd);
+      _rxEnd += bus.readData(_rxBuffer + _rxEnd, n);
     }
   }
-
-  return error;
 }
 }  // namespace RhAL
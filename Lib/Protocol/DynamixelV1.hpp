@@ -28,28 +28,40 @@ class DynamixelV1 : public Protocol
     ErrorInstruction = 64
   };
 
+  /**
+   * Maximum number of parameters of a packet.
+   * The one byte length field also counts
+   * the instruction and the checksum.
+   */
+  static constexpr size_t MaxParameters = 0xFF - 2;
+
+  /**
+   * Size of the reception buffer
+   * (two maximum size frames)
+   */
+  static constexpr size_t RxBufferSize = 2 * (4 + 0xFF);
+
+  /**
+   * Packet with a fixed capacity buffer
+   * so that no heap allocation is done
+   * while talking on the bus
+   */
   class Packet
   {
   public:
     Packet(id_t id, DynamixelV1Command instruction, size_t parameters);
-    Packet(id_t id, size_t parameters);
-    virtual ~Packet();
-
-    /**
-     * Append data to the buffer
-     */
-    void append(uint8_t byte);
-    void append(const uint8_t* data, size_t size);
 
     /**
-     * Sets the status packet error
+     * Reset the packet for given id
+     * and number of parameters
      */
-    void setError(uint8_t error);
+    void reset(id_t id, size_t parameters);
 
     /**
-     * Gets the status packet error
+     * Append data to the buffer
      */
-    uint8_t getError();
+    void append(uint8_t byte);
+    void append(const uint8_t* data, size_t size);
 
     /**
      * Compute the checksum
@@ -75,7 +87,7 @@ class DynamixelV1 : public Protocol
     /**
      * Buffer and number of parameters
      */
-    uint8_t* buffer;
+    uint8_t buffer[2 + 1 + 1 + 1 + MaxParameters + 1];
     size_t parameters;
 
   protected:
@@ -92,11 +104,16 @@ public:
   ResponseState writeAndCheckData(id_t id, addr_t address, const uint8_t* data, size_t size);
   ResponseState readData(id_t id, addr_t address, uint8_t* data, size_t size);
   bool ping(id_t id);
-  std::vector<ResponseState> syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas,
-                                      size_t size);
   void syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas, size_t size);
-  std::vector<ResponseState> syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
-                                               const std::vector<const uint8_t*>& datas, size_t size);
+  void syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas, size_t size,
+                std::vector<ResponseState>& states);
+  void syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
+                         size_t size, std::vector<ResponseState>& states);
+  size_t transactionOverheadBytes() const;
+  size_t maxSyncIds(size_t size) const;
+  using Protocol::syncRead;
+  using Protocol::syncWriteAndCheck;
+
   /**
    * Broadcasts a "disable torque" command
    */
@@ -106,17 +123,26 @@ public:
    * Broadcasts an "enable torque" command
    */
   void exitEmergencyState();
+  using Protocol::emergencyStop;
+  using Protocol::exitEmergencyState;
 
 protected:
   /**
    * This sends a packet over the bus
+   * (queued in pipelined mode if no
+   * response is expected)
    */
-  void sendPacket(Packet& packet);
+  void sendPacket(Packet& packet, bool isResponseExpected = true);
 
   /**
-   * Waits to receive a packet over the bus
+   * Waits to receive a status packet from given id
+   * over the bus. On success, parameters points to
+   * the response parameters inside the reception buffer
+   * (valid until next reception) and size is assigned
+   * to their number. Bytes received after the packet
+   * are kept for the next call.
    */
-  ResponseState receivePacket(Packet*& response, id_t id);
+  ResponseState receivePacket(id_t id, const uint8_t*& parameters, size_t& size);
 
   /**
    * Uses sendPacket and receivePacket to exchange data with the
@@ -127,10 +153,24 @@ protected:
    * Uses sendPacket and receivePacket to exchange data with several
    * devices at once
    */
-  std::vector<ResponseState> syncSendAndReceiveData(DynamixelV1Command instruction, const std::vector<id_t>& ids,
-                                                    addr_t address, const std::vector<uint8_t*>& datas, size_t size);
+  void syncSendAndReceiveData(DynamixelV1Command instruction, const std::vector<id_t>& ids, addr_t address,
+                              const std::vector<uint8_t*>& datas, size_t size, std::vector<ResponseState>& states);
+
+  /**
+   * Return the number of frames needed for
+   * a sync operation over count devices
+   */
+  size_t syncChunksCount(size_t count, size_t size) const;
 
 private:
+  /**
+   * Reception buffer. Bytes from _rxBegin
+   * to _rxEnd are received but not parsed yet.
+   */
+  uint8_t _rxBuffer[RxBufferSize];
+  size_t _rxBegin;
+  size_t _rxEnd;
+
   /**
    * Parameters
    * timeout: wait for receive packet in secondes
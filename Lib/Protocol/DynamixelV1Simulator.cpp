@@ -0,0 +1,373 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <termios.h>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include "DynamixelV1Simulator.hpp"
+#include "timestamp.h"
+
+namespace RhAL
+{
+/**
+ * Protocol 1.0 instructions
+ * and status error flags
+ */
+enum SimulatorCommand
+{
+  CommandPing = 0x01,
+  CommandRead = 0x02,
+  CommandWrite = 0x03,
+  CommandSyncWrite = 0x83,
+  CommandSyncRead = 0x84,
+  CommandSyncWriteAndCheck = 0x85,
+};
+enum SimulatorError
+{
+  ErrorRange = 8,
+  ErrorChecksum = 16,
+  ErrorInstruction = 64
+};
+
+/**
+ * Broadcast id and Rhoban
+ * sync read/check response id
+ */
+static constexpr id_t IdBroadcast = 0xfe;
+static constexpr id_t IdSync = 0xfd;
+
+DynamixelV1Simulator::DynamixelV1Simulator(unsigned int baudrate)
+  : _baudrate(baudrate)
+  , _master(-1)
+  , _slave(-1)
+  , _port()
+  , _tables()
+  , _mutex()
+  , _thread()
+  , _isOver(false)
+  , _packetCount(0)
+  , _rxBuffer()
+  , _lineFree(getTimePoint())
+{
+  _master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0)
+  {
+    if (_master >= 0)
+    {
+      close(_master);
+    }
+    throw std::runtime_error("DynamixelV1Simulator pseudo terminal allocation failed");
+  }
+  _port = ptsname(_master);
+  _slave = open(_port.c_str(), O_RDWR | O_NOCTTY);
+  // Raw binary transfers
+  struct termios tio;
+  if (_slave >= 0 && tcgetattr(_slave, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    tcsetattr(_slave, TCSANOW, &tio);
+  }
+  _thread = std::thread(&DynamixelV1Simulator::run, this);
+}
+
+DynamixelV1Simulator::~DynamixelV1Simulator()
+{
+  _isOver = true;
+  _thread.join();
+  if (_slave >= 0)
+  {
+    close(_slave);
+  }
+  close(_master);
+}
+
+const std::string& DynamixelV1Simulator::port() const
+{
+  return _port;
+}
+
+void DynamixelV1Simulator::addDevice(id_t id)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (id < 0 || id >= IdSync)
+  {
+    throw std::logic_error("DynamixelV1Simulator invalid id: " + std::to_string(id));
+  }
+  if (_tables.count(id) != 0)
+  {
+    throw std::logic_error("DynamixelV1Simulator id already added: " + std::to_string(id));
+  }
+  _tables[id] = std::vector<uint8_t>(TableSize, 0);
+  _tables[id][AddrId] = id;
+  _tables[id][AddrStatusReturn] = 1;
+}
+
+void DynamixelV1Simulator::readTable(id_t id, addr_t addr, uint8_t* data, size_t size) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_tables.count(id) == 0 || addr + size > TableSize)
+  {
+    throw std::logic_error("DynamixelV1Simulator invalid table access: " + std::to_string(id));
+  }
+  memcpy(data, _tables.at(id).data() + addr, size);
+}
+
+void DynamixelV1Simulator::writeTable(id_t id, addr_t addr, const uint8_t* data, size_t size)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_tables.count(id) == 0 || addr + size > TableSize)
+  {
+    throw std::logic_error("DynamixelV1Simulator invalid table access: " + std::to_string(id));
+  }
+  memcpy(_tables.at(id).data() + addr, data, size);
+}
+
+unsigned long DynamixelV1Simulator::packetCount() const
+{
+  return _packetCount;
+}
+
+void DynamixelV1Simulator::run()
+{
+  uint8_t buffer[1024];
+  while (!_isOver)
+  {
+    struct pollfd fds = { _master, POLLIN, 0 };
+    if (poll(&fds, 1, 10) <= 0)
+    {
+      continue;
+    }
+    ssize_t n = read(_master, buffer, sizeof(buffer));
+    if (n <= 0)
+    {
+      continue;
+    }
+    _rxBuffer.insert(_rxBuffer.end(), buffer, buffer + n);
+    processBuffer();
+  }
+}
+
+void DynamixelV1Simulator::processBuffer()
+{
+  size_t pos = 0;
+  while (pos + 4 <= _rxBuffer.size())
+  {
+    // Look for the header
+    if (_rxBuffer[pos] != 0xff || _rxBuffer[pos + 1] != 0xff)
+    {
+      pos++;
+      continue;
+    }
+    size_t length = _rxBuffer[pos + 3];
+    if (length < 2)
+    {
+      pos++;
+      continue;
+    }
+    size_t total = 4 + length;
+    if (pos + total > _rxBuffer.size())
+    {
+      break;
+    }
+    const uint8_t* frame = _rxBuffer.data() + pos;
+    uint8_t checksum = 0;
+    for (size_t k = 2; k < total - 1; k++)
+    {
+      checksum += frame[k];
+    }
+    std::vector<uint8_t> response;
+    if ((uint8_t)~checksum != frame[total - 1])
+    {
+      // Corrupted packet are reported
+      // by the addressed device if any
+      double delay = 0.0;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _tables.find(frame[2]);
+        if (it != _tables.end())
+        {
+          appendStatus(response, frame[2], ErrorChecksum, nullptr, 0);
+          delay = returnDelay(it->second);
+        }
+      }
+      respond(total, response, delay);
+      pos++;
+      continue;
+    }
+    _packetCount++;
+    double delay = processPacket(frame[2], frame[4], frame + 5, length - 2, response);
+    respond(total, response, delay);
+    pos += total;
+  }
+  _rxBuffer.erase(_rxBuffer.begin(), _rxBuffer.begin() + pos);
+}
+
+double DynamixelV1Simulator::processPacket(id_t id, uint8_t instruction, const uint8_t* params, size_t size,
+                                           std::vector<uint8_t>& response)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (instruction == CommandSyncWrite)
+  {
+    // Address, size then id and data for each device
+    if (size < 2)
+    {
+      return 0.0;
+    }
+    addr_t addr = params[0];
+    size_t length = params[1];
+    for (size_t k = 2; k + length + 1 <= size; k += length + 1)
+    {
+      auto it = _tables.find(params[k]);
+      if (it != _tables.end() && addr + length <= TableSize)
+      {
+        memcpy(it->second.data() + addr, params + k + 1, length);
+      }
+    }
+    return 0.0;
+  }
+  if (instruction == CommandSyncRead || instruction == CommandSyncWriteAndCheck)
+  {
+    // Address, size then ids. A single
+    // aggregated status packet is returned
+    // with error and data of each device.
+    if (id != IdSync || size < 2)
+    {
+      return 0.0;
+    }
+    addr_t addr = params[0];
+    size_t length = params[1];
+    std::vector<uint8_t> datas;
+    double delay = 0.0;
+    for (size_t k = 2; k < size; k++)
+    {
+      auto it = _tables.find(params[k]);
+      if (it != _tables.end() && addr + length <= TableSize)
+      {
+        datas.push_back(0x00);
+        datas.insert(datas.end(), it->second.begin() + addr, it->second.begin() + addr + length);
+        delay = std::max(delay, returnDelay(it->second));
+      }
+      else
+      {
+        // Device timeout
+        datas.push_back(0xFF);
+        datas.insert(datas.end(), length, 0x00);
+      }
+    }
+    if (datas.size() + 2 > 0xFF)
+    {
+      return 0.0;
+    }
+    appendStatus(response, IdSync, 0x00, datas.data(), datas.size());
+    return delay;
+  }
+
+  // Single device instructions
+  // (broadcast writes are not answered)
+  bool isBroadcast = (id == IdBroadcast);
+  auto it = _tables.find(id);
+  if (!isBroadcast && it == _tables.end())
+  {
+    return 0.0;
+  }
+  if (instruction == CommandPing)
+  {
+    if (!isBroadcast)
+    {
+      appendStatus(response, id, 0x00, nullptr, 0);
+    }
+  }
+  else if (instruction == CommandRead && !isBroadcast)
+  {
+    if (it->second[AddrStatusReturn] == 0)
+    {
+      return 0.0;
+    }
+    if (size == 2 && params[0] + params[1] <= TableSize)
+    {
+      appendStatus(response, id, 0x00, it->second.data() + params[0], params[1]);
+    }
+    else
+    {
+      appendStatus(response, id, ErrorRange, nullptr, 0);
+    }
+  }
+  else if (instruction == CommandWrite)
+  {
+    uint8_t error = 0x00;
+    if (size >= 1 && params[0] + size - 1 <= TableSize)
+    {
+      for (auto& table : _tables)
+      {
+        if (isBroadcast || table.first == id)
+        {
+          memcpy(table.second.data() + params[0], params + 1, size - 1);
+        }
+      }
+    }
+    else
+    {
+      error = ErrorRange;
+    }
+    if (!isBroadcast && it->second[AddrStatusReturn] >= 2)
+    {
+      appendStatus(response, id, error, nullptr, 0);
+    }
+  }
+  else if (!isBroadcast)
+  {
+    appendStatus(response, id, ErrorInstruction, nullptr, 0);
+  }
+  return isBroadcast ? 0.0 : returnDelay(it->second);
+}
+
+void DynamixelV1Simulator::appendStatus(std::vector<uint8_t>& response, id_t id, uint8_t error,
+                                        const uint8_t* params, size_t size) const
+{
+  size_t begin = response.size();
+  response.push_back(0xff);
+  response.push_back(0xff);
+  response.push_back(id);
+  response.push_back(size + 2);
+  response.push_back(error);
+  response.insert(response.end(), params, params + size);
+  uint8_t checksum = 0;
+  for (size_t k = begin + 2; k < response.size(); k++)
+  {
+    checksum += response[k];
+  }
+  response.push_back(~checksum);
+}
+
+void DynamixelV1Simulator::respond(size_t requestSize, const std::vector<uint8_t>& response, double returnDelay)
+{
+  // The request is received once all its
+  // bytes are transmitted on the free line
+  double byteDuration = _baudrate > 0 ? 10.0 / _baudrate : 0.0;
+  TimePoint now = getTimePoint();
+  TimePoint received = std::max(now, _lineFree) +
+                       std::chrono::duration_cast<TimePoint::duration>(TimeDurationFloat(requestSize * byteDuration));
+  if (response.size() == 0)
+  {
+    _lineFree = received;
+    return;
+  }
+  // The response is available once
+  // transmitted after return delay
+  _lineFree = received + std::chrono::duration_cast<TimePoint::duration>(
+                             TimeDurationFloat(returnDelay + response.size() * byteDuration));
+  std::this_thread::sleep_until(_lineFree);
+  if (write(_master, response.data(), response.size()) != (ssize_t)response.size())
+  {
+    std::cerr << "WARNING: DynamixelV1Simulator::respond(): write failed" << std::endl;
+  }
+}
+
+double DynamixelV1Simulator::returnDelay(const std::vector<uint8_t>& table) const
+{
+  return table[AddrReturnDelay] * 2e-6;
+}
+}  // namespace RhAL
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include "types.h"
+
+namespace RhAL
+{
+/**
+ * DynamixelV1Simulator
+ *
+ * Simulated Dynamixel protocol 1.0 devices
+ * answering on a pseudo terminal. A SerialBus
+ * (or NativeSerialBus) opened on port() with the
+ * DynamixelV1 Protocol talks to the simulated
+ * devices as to real hardware.
+ * Each device has an in memory control table.
+ * Supported instructions: ping, read, write,
+ * sync write (0x83) and Rhoban sync read (0x84)
+ * and sync write and check (0x85).
+ * Transmission time of each byte at configured
+ * baudrate and each device return delay time
+ * (control table address 0x05, 2us unit) are
+ * emulated before sending responses.
+ */
+class DynamixelV1Simulator
+{
+public:
+  /**
+   * Size of devices control table
+   */
+  static constexpr size_t TableSize = 256;
+
+  /**
+   * Control table addresses of id, return
+   * delay time and status return level
+   * (0: ping only, 1: ping and read, 2: all)
+   */
+  static constexpr addr_t AddrId = 0x03;
+  static constexpr addr_t AddrReturnDelay = 0x05;
+  static constexpr addr_t AddrStatusReturn = 0x10;
+
+  /**
+   * Allocate the pseudo terminal and start
+   * the simulation thread with given emulated
+   * baudrate (0 disables timing emulation).
+   * Throw std::runtime_error on failure.
+   */
+  DynamixelV1Simulator(unsigned int baudrate);
+
+  /**
+   * Stop the simulation thread
+   * and close the pseudo terminal
+   */
+  ~DynamixelV1Simulator();
+
+  /**
+   * Return the system path of the pseudo
+   * terminal side to be opened by a Bus
+   */
+  const std::string& port() const;
+
+  /**
+   * Add a simulated device with given id.
+   * The control table is zero initialized
+   * except for the id and the status return
+   * level set to 1 (writes are not answered
+   * as DynamixelV1::writeData() does not wait
+   * for a status packet).
+   * Throw std::logic_error if the id is invalid
+   * or already exists.
+   */
+  void addDevice(id_t id);
+
+  /**
+   * Copy size bytes of given device control
+   * table at given address from or to data.
+   * Throw std::logic_error if the device does
+   * not exist or the range is invalid.
+   */
+  void readTable(id_t id, addr_t addr, uint8_t* data, size_t size) const;
+  void writeTable(id_t id, addr_t addr, const uint8_t* data, size_t size);
+
+  /**
+   * Return the number of received
+   * instruction packets (with valid checksum)
+   */
+  unsigned long packetCount() const;
+
+private:
+  /**
+   * Emulated baudrate
+   */
+  unsigned int _baudrate;
+
+  /**
+   * Pseudo terminal master file descriptor
+   * and a slave descriptor kept opened so that
+   * the master never sees a hang up.
+   */
+  int _master;
+  int _slave;
+  std::string _port;
+
+  /**
+   * Control table of each device
+   * (protected by _mutex)
+   */
+  std::map<id_t, std::vector<uint8_t>> _tables;
+  mutable std::mutex _mutex;
+
+  /**
+   * Simulation thread and stop flag
+   */
+  std::thread _thread;
+  std::atomic<bool> _isOver;
+
+  /**
+   * Received instruction packets count
+   */
+  std::atomic<unsigned long> _packetCount;
+
+  /**
+   * Pending received bytes and the time
+   * at which the emulated line is free
+   */
+  std::vector<uint8_t> _rxBuffer;
+  TimePoint _lineFree;
+
+  /**
+   * Simulation thread main loop
+   */
+  void run();
+
+  /**
+   * Parse and process all complete
+   * packets in reception buffer
+   */
+  void processBuffer();
+
+  /**
+   * Process a received instruction packet,
+   * append the status packet to send back (if any)
+   * to given response and return the device
+   * return delay time in seconds
+   */
+  double processPacket(id_t id, uint8_t instruction, const uint8_t* params, size_t size,
+                       std::vector<uint8_t>& response);
+
+  /**
+   * Append a status packet with given id,
+   * error and parameters to given response
+   */
+  void appendStatus(std::vector<uint8_t>& response, id_t id, uint8_t error, const uint8_t* params,
+                    size_t size) const;
+
+  /**
+   * Emulate the transmission of a request of
+   * given size and send given response after
+   * given return delay time (in seconds)
+   */
+  void respond(size_t requestSize, const std::vector<uint8_t>& response, double returnDelay);
+
+  /**
+   * Return the emulated device return
+   * delay time in seconds (_mutex locked)
+   */
+  double returnDelay(const std::vector<uint8_t>& table) const;
+};
+}  // namespace RhAL
@@ -0,0 +1,721 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+#include <thread>
+#include "DynamixelV2.hpp"
+
+using namespace std;
+
+namespace RhAL
+{
+/**
+ * Maximum accepted length field of a
+ * received packet. Larger values are
+ * considered as corrupted headers.
+ */
+static constexpr size_t MaxPacketLength = 1024;
+
+/**
+ * Devices answer a broadcast ping one after
+ * the other, each in a time slot given by its
+ * id. The whole id range has to be waited for.
+ */
+static constexpr int BroadcastPingSlots = 253;
+static constexpr std::chrono::milliseconds BroadcastPingSlot(3);
+
+/**
+ * Slicing-by-8 lookup tables for CRC16
+ * with polynomial 0x8005.
+ * Table k gives the CRC contribution of a
+ * byte followed by k zero bytes.
+ */
+struct CRCTables
+{
+  uint16_t table[8][256];
+
+  CRCTables()
+  {
+    for (unsigned int i = 0; i < 256; i++)
+    {
+      uint16_t crc = i << 8;
+      for (unsigned int j = 0; j < 8; j++)
+      {
+        if (crc & 0x8000)
+        {
+          crc = (crc << 1) ^ 0x8005;
+        }
+        else
+        {
+          crc = crc << 1;
+        }
+      }
+      table[0][i] = crc;
+    }
+    for (unsigned int k = 1; k < 8; k++)
+    {
+      for (unsigned int i = 0; i < 256; i++)
+      {
+        uint16_t prev = table[k - 1][i];
+        table[k][i] = (prev << 8) ^ table[0][prev >> 8];
+      }
+    }
+  }
+};
+static const CRCTables crcTables;
+
+DynamixelV2::DynamixelV2(Bus& bus)
+  : Protocol(bus)
+  , _txBuffer()
+  , _txStuffingState(0)
+  , _rxBuffer()
+  , _rxBegin(0)
+  , _rxParams()
+  , _timeout("timeout", 0.01)
+  , _waitAfterWrite("waitAfterWrite", 0.0005)
+  , _pingUnknown("pingUnknown", false)
+{
+  _parametersList.add(&_timeout);
+  _parametersList.add(&_waitAfterWrite);
+  _parametersList.add(&_pingUnknown);
+  // Preallocate buffers
+  _txBuffer.reserve(MaxPacketLength);
+  _rxBuffer.reserve(MaxPacketLength);
+  _rxParams.reserve(MaxPacketLength);
+}
+
+uint16_t DynamixelV2::computeCRC(uint16_t crc, const uint8_t* data, size_t size)
+{
+  const uint16_t(*t)[256] = crcTables.table;
+  // The 16 bits current crc only
+  // affect the two first bytes of a block
+  while (size >= 8)
+  {
+    crc = t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0xFF)] ^ t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^
+          t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    data += 8;
+    size -= 8;
+  }
+  while (size > 0)
+  {
+    crc = (crc << 8) ^ t[0][((crc >> 8) ^ *data) & 0xFF];
+    data++;
+    size--;
+  }
+
+  return crc;
+}
+
+void DynamixelV2::writeData(id_t id, addr_t address, const uint8_t* data, size_t size)
+{
+  beginPacket(id, CommandWrite);
+  appendPacketWord(address);
+  appendPacket(data, size);
+  sendPacket(false);
+  // Can't talk to the servos too soon
+  waitAfterWrite(_waitAfterWrite.value);
+}
+
+ResponseState DynamixelV2::writeAndCheckData(id_t id, addr_t address, const uint8_t* data, size_t size)
+{
+  beginPacket(id, CommandWrite);
+  appendPacketWord(address);
+  appendPacket(data, size);
+  sendPacket();
+
+  return sendAndReceiveData(id, nullptr, 0);
+}
+
+ResponseState DynamixelV2::readData(id_t id, addr_t address, uint8_t* data, size_t size)
+{
+  beginPacket(id, CommandRead);
+  appendPacketWord(address);
+  appendPacketWord(size);
+  sendPacket();
+
+  return sendAndReceiveData(id, data, size);
+}
+
+bool DynamixelV2::ping(id_t id)
+{
+  beginPacket(id, CommandPing);
+  sendPacket();
+
+  // Model number and firmware version
+  uint8_t data[3];
+  return (sendAndReceiveData(id, data, 3) & ResponseOK);
+}
+
+void DynamixelV2::syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas,
+                           size_t size, std::vector<ResponseState>& states)
+{
+  if (ids.size() != datas.size())
+  {
+    throw runtime_error("ids and datas should have the same size() for syncRead");
+  }
+
+  beginPacket(Broadcast, CommandSyncRead);
+  appendPacketWord(address);
+  appendPacketWord(size);
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    appendPacket(ids[i]);
+  }
+  sendPacket();
+
+  receiveMultipleData(ids, datas, {}, size, states);
+}
+
+void DynamixelV2::syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
+                            size_t size)
+{
+  if (ids.size() != datas.size())
+  {
+    throw runtime_error("ids and datas should have the same size() for syncWrite");
+  }
+
+  beginPacket(Broadcast, CommandSyncWrite);
+  appendPacketWord(address);
+  appendPacketWord(size);
+  for (size_t k = 0; k < ids.size(); k++)
+  {
+    appendPacket(ids[k]);
+    appendPacket(datas[k], size);
+  }
+  sendPacket(false);
+  // Can't talk to the servos too soon
+  waitAfterWrite(_waitAfterWrite.value);
+}
+
+void DynamixelV2::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                    const std::vector<const uint8_t*>& datas, size_t size,
+                                    std::vector<ResponseState>& states)
+{
+  if (ids.size() != datas.size())
+  {
+    throw runtime_error("ids and datas should have the same size() for syncWriteAndCheck");
+  }
+
+  // Protocol 2.0 sync write is never acknowledged.
+  // Checked writes are sent one by one.
+  states.resize(ids.size());
+  for (size_t k = 0; k < ids.size(); k++)
+  {
+    states[k] = writeAndCheckData(ids[k], address, datas[k], size);
+  }
+}
+
+bool DynamixelV2::isBulkSupported() const
+{
+  return true;
+}
+
+void DynamixelV2::bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                           const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes,
+                           std::vector<ResponseState>& states)
+{
+  if (ids.size() != datas.size() || ids.size() != addresses.size() || ids.size() != sizes.size())
+  {
+    throw runtime_error("ids, addresses, datas and sizes should have the same size() for bulkRead");
+  }
+
+  beginPacket(Broadcast, CommandBulkRead);
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    appendPacket(ids[i]);
+    appendPacketWord(addresses[i]);
+    appendPacketWord(sizes[i]);
+  }
+  sendPacket();
+
+  receiveMultipleData(ids, datas, sizes, 0, states);
+}
+
+void DynamixelV2::bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                            const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes)
+{
+  if (ids.size() != datas.size() || ids.size() != addresses.size() || ids.size() != sizes.size())
+  {
+    throw runtime_error("ids, addresses, datas and sizes should have the same size() for bulkWrite");
+  }
+
+  beginPacket(Broadcast, CommandBulkWrite);
+  for (size_t k = 0; k < ids.size(); k++)
+  {
+    appendPacket(ids[k]);
+    appendPacketWord(addresses[k]);
+    appendPacketWord(sizes[k]);
+    appendPacket(datas[k], sizes[k]);
+  }
+  sendPacket(false);
+  // Can't talk to the servos too soon
+  waitAfterWrite(_waitAfterWrite.value);
+}
+
+size_t DynamixelV2::transactionOverheadBytes() const
+{
+  // Read request: header (4), id, length (2),
+  // instruction, address (2), size (2) and CRC (2).
+  // Status response: header (4), id, length (2),
+  // instruction, error and CRC (2).
+  return 14 + 11;
+}
+
+void DynamixelV2::emergencyStop()
+{
+  // Disable torque
+  writeTorqueEnable(0, {}, {}, true);
+}
+
+void DynamixelV2::exitEmergencyState()
+{
+  // Enable torque
+  writeTorqueEnable(1, {}, {}, true);
+}
+
+void DynamixelV2::emergencyStop(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses)
+{
+  // Disable torque
+  writeTorqueEnable(0, ids, addresses, _pingUnknown.value);
+}
+
+void DynamixelV2::exitEmergencyState(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses)
+{
+  // Enable torque. Devices unknown
+  // by the manager are left stopped.
+  writeTorqueEnable(1, ids, addresses, false);
+}
+
+bool DynamixelV2::torqueEnableAddress(uint16_t model, addr_t& address)
+{
+  switch (model)
+  {
+    // XL320 control table. Address 24 is
+    // an EEPROM register on X-series.
+    case 350:
+      address = 0x18;
+      return true;
+    // MX-28, MX-64 and MX-106 (2.0 firmware)
+    case 30:
+    case 311:
+    case 321:
+    // XH430, XM430, XL430, XC430, XH540,
+    // XM540, XW540 and XL330/XC330
+    case 1000:
+    case 1010:
+    case 1020:
+    case 1030:
+    case 1040:
+    case 1050:
+    case 1060:
+    case 1070:
+    case 1080:
+    case 1090:
+    case 1100:
+    case 1110:
+    case 1120:
+    case 1130:
+    case 1140:
+    case 1150:
+    case 1160:
+    case 1170:
+    case 1180:
+    case 1190:
+    case 1200:
+    case 1210:
+    case 1220:
+    case 1230:
+    case 1240:
+      address = 0x40;
+      return true;
+    default:
+      // PRO and P-series control tables differ.
+      // Never write a guessed address.
+      return false;
+  }
+}
+
+void DynamixelV2::beginPacket(id_t id, DynamixelV2Command instruction)
+{
+  _txBuffer.clear();
+  // Header, reserved byte and id
+  _txBuffer.push_back(0xFF);
+  _txBuffer.push_back(0xFF);
+  _txBuffer.push_back(0xFD);
+  _txBuffer.push_back(0x00);
+  _txBuffer.push_back(id);
+  // Length, set in sendPacket()
+  _txBuffer.push_back(0x00);
+  _txBuffer.push_back(0x00);
+  // Byte stuffing applies from
+  // the instruction field
+  _txStuffingState = 0;
+  appendPacket(instruction);
+}
+
+void DynamixelV2::appendPacket(uint8_t byte)
+{
+  _txBuffer.push_back(byte);
+  // Track the 0xFF 0xFF 0xFD header pattern
+  // and insert a 0xFD byte after it
+  if (byte == 0xFF)
+  {
+    _txStuffingState = (_txStuffingState >= 2) ? 2 : _txStuffingState + 1;
+  }
+  else if (byte == 0xFD && _txStuffingState == 2)
+  {
+    _txBuffer.push_back(0xFD);
+    _txStuffingState = 0;
+  }
+  else
+  {
+    _txStuffingState = 0;
+  }
+}
+
+void DynamixelV2::appendPacket(const uint8_t* data, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    appendPacket(data[i]);
+  }
+}
+
+void DynamixelV2::appendPacketWord(uint16_t word)
+{
+  appendPacket(word & 0xFF);
+  appendPacket((word >> 8) & 0xFF);
+}
+
+void DynamixelV2::sendPacket(bool isResponseExpected)
+{
+  // Length counts stuffed instruction
+  // and parameters plus CRC
+  size_t length = _txBuffer.size() - 7 + 2;
+  _txBuffer[5] = length & 0xFF;
+  _txBuffer[6] = (length >> 8) & 0xFF;
+  uint16_t crc = computeCRC(0, _txBuffer.data(), _txBuffer.size());
+  _txBuffer.push_back(crc & 0xFF);
+  _txBuffer.push_back((crc >> 8) & 0xFF);
+
+  // Pending received bytes are outdated
+  _rxBuffer.clear();
+  _rxBegin = 0;
+  sendRequest(_txBuffer.data(), _txBuffer.size(), isResponseExpected);
+}
+
+ResponseState DynamixelV2::receivePacket(id_t& id, const TimePoint& deadline)
+{
+  ResponseState error = ResponseQuiet;
+  while (true)
+  {
+    // Try to decode a packet
+    // from already received bytes
+    bool isNeedData = false;
+    while (!isNeedData)
+    {
+      const uint8_t* buffer = _rxBuffer.data();
+      size_t end = _rxBuffer.size();
+      // Look for the first header byte
+      const uint8_t* found = static_cast<const uint8_t*>(memchr(buffer + _rxBegin, 0xFF, end - _rxBegin));
+      if (found == nullptr)
+      {
+        _rxBegin = end;
+        isNeedData = true;
+        break;
+      }
+      size_t pos = found - buffer;
+      _rxBegin = pos;
+      // Wait for header, id and length fields
+      if (pos + 7 > end)
+      {
+        isNeedData = true;
+        break;
+      }
+      if (buffer[pos + 1] != 0xFF || buffer[pos + 2] != 0xFD || buffer[pos + 3] != 0x00)
+      {
+        _rxBegin = pos + 1;
+        continue;
+      }
+      // Validate length before waiting
+      // for the whole packet
+      size_t length = buffer[pos + 5] | (buffer[pos + 6] << 8);
+      if (length < 4 || length > MaxPacketLength)
+      {
+        error |= ResponseBadSize;
+        _rxBegin = pos + 1;
+        continue;
+      }
+      size_t total = 7 + length;
+      if (pos + total > end)
+      {
+        isNeedData = true;
+        break;
+      }
+      // The packet is consumed
+      _rxBegin = pos + total;
+      uint16_t crc = computeCRC(0, buffer + pos, total - 2);
+      if (crc != (buffer[pos + total - 2] | (buffer[pos + total - 1] << 8)))
+      {
+        return ResponseBadChecksum;
+      }
+      if (buffer[pos + 7] != CommandStatus)
+      {
+        // Not a status packet
+        continue;
+      }
+      id = buffer[pos + 4];
+      // Unstuff error and parameters
+      _rxParams.clear();
+      unsigned int state = 0;
+      bool isSkip = false;
+      bool isError = true;
+      uint8_t deviceError = 0;
+      for (size_t k = pos + 7; k < pos + total - 2; k++)
+      {
+        uint8_t byte = buffer[k];
+        if (isSkip)
+        {
+          isSkip = false;
+          continue;
+        }
+        if (byte == 0xFF)
+        {
+          state = (state >= 2) ? 2 : state + 1;
+        }
+        else if (byte == 0xFD && state == 2)
+        {
+          isSkip = true;
+          state = 0;
+        }
+        else
+        {
+          state = 0;
+        }
+        if (k == pos + 7)
+        {
+          // Instruction field
+          continue;
+        }
+        if (isError)
+        {
+          deviceError = byte;
+          isError = false;
+        }
+        else
+        {
+          _rxParams.push_back(byte);
+        }
+      }
+      if (isError)
+      {
+        return ResponseBadSize;
+      }
+
+      return decodeError(deviceError);
+    }
+
+    // Wait for more data. On timeout, the
+    // quiet flag is always set
+    TimePoint now = getTimePoint();
+    if (now >= deadline)
+    {
+      return error;
+    }
+    if (bus.waitForData(duration_float(now, deadline)))
+    {
+      // Drop consumed bytes
+      if (_rxBegin > 0)
+      {
+        _rxBuffer.erase(_rxBuffer.begin(), _rxBuffer.begin() + _rxBegin);
+        _rxBegin = 0;
+      }
+      size_t n = bus.available();
+      size_t size = _rxBuffer.size();
+      _rxBuffer.resize(size + n);
+      n = bus.readData(_rxBuffer.data() + size, n);
+      _rxBuffer.resize(size + n);
+    }
+  }
+}
+
+void DynamixelV2::receiveMultipleData(const std::vector<id_t>& ids, const std::vector<uint8_t*>& datas,
+                                      const std::vector<size_t>& sizes, size_t size,
+                                      std::vector<ResponseState>& states)
+{
+  // Each device sends back its own status packet
+  // in the requested order. A missing device
+  // only invalidates its own response.
+  states.assign(ids.size(), ResponseQuiet);
+  size_t remaining = ids.size();
+  TimePoint deadline = getTimePoint() + getTimeoutDuration();
+  while (remaining > 0)
+  {
+    id_t id = 0;
+    ResponseState state = receivePacket(id, deadline);
+    if (state & ResponseQuiet)
+    {
+      break;
+    }
+    if (state & ResponseBadChecksum)
+    {
+      // Sender is unknown
+      continue;
+    }
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      if (ids[i] == id && states[i] == ResponseQuiet)
+      {
+        size_t expected = sizes.empty() ? size : sizes[i];
+        if ((state & ResponseOK) && _rxParams.size() != expected)
+        {
+          state = ResponseBadSize;
+        }
+        if (state & ResponseOK)
+        {
+          memcpy(datas[i], _rxParams.data(), expected);
+        }
+        states[i] = state;
+        remaining--;
+        break;
+      }
+    }
+  }
+}
+
+TimePoint::duration DynamixelV2::getTimeoutDuration() const
+{
+  return std::chrono::duration_cast<TimePoint::duration>(TimeDurationFloat(_timeout.value));
+}
+
+ResponseState DynamixelV2::sendAndReceiveData(id_t id, uint8_t* data, size_t size)
+{
+  ResponseState error = ResponseQuiet;
+  TimePoint deadline = getTimePoint() + getTimeoutDuration();
+  while (true)
+  {
+    id_t responseId;
+    ResponseState state = receivePacket(responseId, deadline);
+    if (state & ResponseQuiet)
+    {
+      return (error == ResponseBadId) ? error : state;
+    }
+    if (!(state & ResponseOK))
+    {
+      return state;
+    }
+    if (responseId != id)
+    {
+      error = ResponseBadId;
+      continue;
+    }
+    if (_rxParams.size() != size)
+    {
+      return ResponseBadSize;
+    }
+    if (size > 0)
+    {
+      memcpy(data, _rxParams.data(), size);
+    }
+
+    return state;
+  }
+}
+
+void DynamixelV2::writeTorqueEnable(uint8_t value, const std::vector<id_t>& ids,
+                                    const std::vector<addr_t>& addresses, bool isPing)
+{
+  if (ids.size() != addresses.size())
+  {
+    throw runtime_error("ids and addresses should have the same size() for writeTorqueEnable");
+  }
+
+  // Known devices are written first
+  // without waiting for any answer
+  syncWriteByAddress(value, ids, addresses);
+  if (!isPing)
+  {
+    return;
+  }
+
+  // Other devices answer a broadcast
+  // ping with their model number
+  beginPacket(Broadcast, CommandPing);
+  sendPacket();
+  std::vector<id_t> unknownIds;
+  std::vector<addr_t> unknownAddresses;
+  TimePoint deadline = getTimePoint() + getTimeoutDuration() + BroadcastPingSlots * BroadcastPingSlot;
+  while (true)
+  {
+    id_t id = 0;
+    ResponseState state = receivePacket(id, deadline);
+    if (state & ResponseQuiet)
+    {
+      break;
+    }
+    addr_t address;
+    if ((state & ResponseBadChecksum) || _rxParams.size() != 3 ||
+        std::find(ids.begin(), ids.end(), id) != ids.end() ||
+        std::find(unknownIds.begin(), unknownIds.end(), id) != unknownIds.end() ||
+        !torqueEnableAddress(_rxParams[0] | (_rxParams[1] << 8), address))
+    {
+      continue;
+    }
+    unknownIds.push_back(id);
+    unknownAddresses.push_back(address);
+  }
+  syncWriteByAddress(value, unknownIds, unknownAddresses);
+}
+
+void DynamixelV2::syncWriteByAddress(uint8_t value, const std::vector<id_t>& ids,
+                                     const std::vector<addr_t>& addresses)
+{
+  std::vector<id_t> syncIds;
+  std::vector<const uint8_t*> datas;
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    if (std::find(addresses.begin(), addresses.begin() + i, addresses[i]) != addresses.begin() + i)
+    {
+      continue;
+    }
+    syncIds.clear();
+    datas.clear();
+    for (size_t k = i; k < ids.size(); k++)
+    {
+      if (addresses[k] == addresses[i])
+      {
+        syncIds.push_back(ids[k]);
+        datas.push_back(&value);
+      }
+    }
+    syncWrite(syncIds, addresses[i], datas, 1);
+  }
+}
+
+ResponseState DynamixelV2::decodeError(uint8_t error) const
+{
+  switch (error & 0x7F)
+  {
+    case 0:
+      break;
+    case ErrorCRC:
+      return ResponseDeviceBadChecksum;
+    case ErrorInstruction:
+      return ResponseDeviceBadInstruction;
+    case ErrorDataLength:
+      return ResponseBadSize;
+    default:
+      // Result fail, data range,
+      // data limit and access errors
+      return ResponseBadProtocol;
+  }
+  // Hardware error status has
+  // to be read from the device
+  if (error & ErrorAlert)
+  {
+    return ResponseOK | ResponseAlert;
+  }
+
+  return ResponseOK;
+}
+
+}  // namespace RhAL
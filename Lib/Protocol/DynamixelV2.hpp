@@ -0,0 +1,221 @@
+#pragma once
+
+#include <vector>
+#include "Protocol.hpp"
+#include "Manager/Parameter.hpp"
+
+namespace RhAL
+{
+/**
+ * DynamixelV2
+ *
+ * Dynamixel protocol 2.0 implementation
+ * (XL320 and X-series devices)
+ */
+class DynamixelV2 : public Protocol
+{
+  enum DynamixelV2Command
+  {
+    CommandPing = 0x01,
+    CommandRead = 0x02,
+    CommandWrite = 0x03,
+    CommandStatus = 0x55,
+    CommandSyncRead = 0x82,
+    CommandSyncWrite = 0x83,
+    CommandBulkRead = 0x92,
+    CommandBulkWrite = 0x93,
+  };
+
+  enum DynamixelV2Error
+  {
+    ErrorResultFail = 1,
+    ErrorInstruction = 2,
+    ErrorCRC = 3,
+    ErrorDataRange = 4,
+    ErrorDataLength = 5,
+    ErrorDataLimit = 6,
+    ErrorAccess = 7,
+    ErrorAlert = 0x80
+  };
+
+public:
+  DynamixelV2(Bus& bus);
+
+  /**
+   * Implementations from Protocol
+   */
+  void writeData(id_t id, addr_t address, const uint8_t* data, size_t size);
+  ResponseState writeAndCheckData(id_t id, addr_t address, const uint8_t* data, size_t size);
+  ResponseState readData(id_t id, addr_t address, uint8_t* data, size_t size);
+  bool ping(id_t id);
+  void syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas, size_t size,
+                std::vector<ResponseState>& states);
+  void syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas, size_t size);
+  void syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
+                         size_t size, std::vector<ResponseState>& states);
+  bool isBulkSupported() const;
+  void bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses, const std::vector<uint8_t*>& datas,
+                const std::vector<size_t>& sizes, std::vector<ResponseState>& states);
+  void bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                 const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes);
+  size_t transactionOverheadBytes() const;
+  using Protocol::syncRead;
+  using Protocol::syncWriteAndCheck;
+  using Protocol::bulkRead;
+
+  /**
+   * Sends a "disable torque" command to
+   * all devices answering a broadcast ping
+   */
+  void emergencyStop();
+
+  /**
+   * Sends an "enable torque" command to
+   * all devices answering a broadcast ping
+   */
+  void exitEmergencyState();
+
+  /**
+   * Sends a "disable torque" command to given
+   * known devices at given torque enable register
+   * addresses and then, if pingUnknown is set, to
+   * the other devices answering a broadcast ping
+   */
+  void emergencyStop(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses);
+
+  /**
+   * Sends an "enable torque" command to
+   * given known devices only
+   */
+  void exitEmergencyState(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses);
+
+  /**
+   * Assign the torque enable register
+   * address of given model number
+   * (24 on XL320, 64 on MX 2.0 and X-series).
+   * Return false for unsupported models.
+   */
+  static bool torqueEnableAddress(uint16_t model, addr_t& address);
+
+  /**
+   * Update and return the protocol CRC16
+   * (polynomial 0x8005, no reflection) of given
+   * crc with given data buffer.
+   * The CRC of a whole packet starts with 0.
+   * Eight bytes are processed per step using
+   * slicing-by-8 lookup tables.
+   */
+  static uint16_t computeCRC(uint16_t crc, const uint8_t* data, size_t size);
+
+protected:
+  /**
+   * Reset the emission buffer with a new packet
+   * header for given id and instruction
+   */
+  void beginPacket(id_t id, DynamixelV2Command instruction);
+
+  /**
+   * Append parameters to the packet
+   * in emission buffer with byte stuffing
+   */
+  void appendPacket(uint8_t byte);
+  void appendPacket(const uint8_t* data, size_t size);
+  void appendPacketWord(uint16_t word);
+
+  /**
+   * Write length and CRC fields and
+   * send the packet in emission buffer
+   * (queued in pipelined mode if no
+   * response is expected)
+   */
+  void sendPacket(bool isResponseExpected = true);
+
+  /**
+   * Wait for a valid status packet until given
+   * deadline. On success, the sender id is assigned
+   * and the unstuffed parameters are available
+   * in _rxParams.
+   */
+  ResponseState receivePacket(id_t& id, const TimePoint& deadline);
+
+  /**
+   * Exchange a single read like transaction with
+   * a device and copy size bytes of the response
+   * parameters into data
+   */
+  ResponseState sendAndReceiveData(id_t id, uint8_t* data, size_t size);
+
+  /**
+   * Receive the status packets sent back to back
+   * by given devices after a sync or bulk read and
+   * copy sizes[i] bytes of parameters into datas[i].
+   * If sizes is empty, size is used for all devices.
+   */
+  void receiveMultipleData(const std::vector<id_t>& ids, const std::vector<uint8_t*>& datas,
+                           const std::vector<size_t>& sizes, size_t size, std::vector<ResponseState>& states);
+
+  /**
+   * Return the timeout parameter as duration
+   */
+  TimePoint::duration getTimeoutDuration() const;
+
+  /**
+   * Convert a status packet error
+   * field to a ResponseState
+   */
+  ResponseState decodeError(uint8_t error) const;
+
+  /**
+   * Write given value into the torque enable
+   * register of given devices, one sync write
+   * per register address. If isPing is true,
+   * the other devices are discovered by a
+   * broadcast ping and written the same way.
+   */
+  void writeTorqueEnable(uint8_t value, const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                         bool isPing);
+
+  /**
+   * Send one sync write of given value per
+   * distinct address in given addresses
+   */
+  void syncWriteByAddress(uint8_t value, const std::vector<id_t>& ids, const std::vector<addr_t>& addresses);
+
+private:
+  /**
+   * Emission buffer and number of matched
+   * bytes of the stuffing pattern (0xFF 0xFF 0xFD)
+   */
+  std::vector<uint8_t> _txBuffer;
+  unsigned int _txStuffingState;
+
+  /**
+   * Reception buffer. Bytes before _rxBegin
+   * are already consumed. Received bytes are
+   * kept between packets since sync read status
+   * packets are sent back to back.
+   */
+  std::vector<uint8_t> _rxBuffer;
+  size_t _rxBegin;
+
+  /**
+   * Unstuffed parameters of
+   * the last received packet
+   */
+  std::vector<uint8_t> _rxParams;
+
+  /**
+   * Parameters
+   * timeout: wait for receive packet in secondes
+   * waitAfterWrite: a delay in seconds to wait
+   * after each write
+   * pingUnknown: if true, emergency stop also
+   * discovers by a broadcast ping the devices
+   * not known by the manager
+   */
+  ParameterNumber _timeout;
+  ParameterNumber _waitAfterWrite;
+  ParameterBool _pingUnknown;
+};
+
+}  // namespace RhAL
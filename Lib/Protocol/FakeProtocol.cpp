@@ -8,8 +8,20 @@ static std::uniform_real_distribution<> dist(0.0, 1.0);
 
 namespace RhAL
 {
-FakeProtocol::FakeProtocol(Bus& bus) : Protocol(bus), _verbose("verbose", false)
+FakeProtocol::FakeProtocol(Bus& bus)
+  : Protocol(bus), _verbose("verbose", false), _quietId("quietId", 0), _pingAnswer("pingAnswer", false)
 {
+  _parametersList.add(&_quietId);
+  _parametersList.add(&_pingAnswer);
+}
+
+ResponseState FakeProtocol::responseState(id_t id) const
+{
+  if (_quietId.value > 0 && id == (id_t)_quietId.value)
+  {
+    return ResponseQuiet;
+  }
+  return ResponseOK;
 }
 
 void FakeProtocol::writeData(id_t id, addr_t address, const uint8_t* data, size_t size)
@@ -44,6 +56,10 @@ ResponseState FakeProtocol::readData(id_t id, addr_t address, uint8_t* data, siz
   if (_verbose.value)
     std::cout << std::endl;
   std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  if (responseState(id) != ResponseOK)
+  {
+    return responseState(id);
+  }
   return (ResponseOK | ResponseOverload | ResponseOverheat);
 }
 
@@ -67,21 +83,21 @@ bool FakeProtocol::ping(id_t id)
     std::cout << "Ping id=" << id << std::endl;
   }
   std::this_thread::sleep_for(std::chrono::milliseconds(1));
-  return false;
+  return _pingAnswer.value && responseState(id) == ResponseOK;
 }
 
-std::vector<ResponseState> FakeProtocol::syncRead(const std::vector<id_t>& ids, addr_t address,
-                                                  const std::vector<uint8_t*>& datas, size_t size)
+void FakeProtocol::syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas,
+                            size_t size, std::vector<ResponseState>& states)
 {
   (void)datas;
-  std::vector<ResponseState> states;
+  states.clear();
   if (_verbose.value)
     std::cout << "SyncRead ids={";
   for (size_t i = 0; i < ids.size(); i++)
   {
     if (_verbose.value)
       std::cout << ids[i] << ",";
-    states.push_back(ResponseOK);
+    states.push_back(responseState(ids[i]));
   }
   if (_verbose.value)
   {
@@ -102,8 +118,6 @@ std::vector<ResponseState> FakeProtocol::syncRead(const std::vector<id_t>& ids,
   if (_verbose.value)
     std::cout << std::endl;
   std::this_thread::sleep_for(std::chrono::milliseconds(1));
-
-  return states;
 }
 
 void FakeProtocol::syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
@@ -131,8 +145,9 @@ void FakeProtocol::syncWrite(const std::vector<id_t>& ids, addr_t address, const
   std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
-std::vector<ResponseState> FakeProtocol::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
-                                                           const std::vector<const uint8_t*>& datas, size_t size)
+void FakeProtocol::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                     const std::vector<const uint8_t*>& datas, size_t size,
+                                     std::vector<ResponseState>& states)
 {
   (void)address;
   (void)datas;
@@ -141,12 +156,59 @@ std::vector<ResponseState> FakeProtocol::syncWriteAndCheck(const std::vector<id_
   {
     std::cout << "Not implemented yet in fakeProtocol" << std::endl;
   }
-  std::vector<ResponseState> output;
-  for (unsigned int i = 0; i < ids.size(); i++)
+  states.assign(ids.size(), ResponseOK);
+}
+
+bool FakeProtocol::isBulkSupported() const
+{
+  return true;
+}
+
+void FakeProtocol::bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                            const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes,
+                            std::vector<ResponseState>& states)
+{
+  states.clear();
+  if (_verbose.value)
+    std::cout << "BulkRead {";
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    if (_verbose.value)
+      std::cout << "id=" << ids[i] << " addr=" << addresses[i] << " size=" << sizes[i];
+    if (sizes[i] == 4)
+    {
+      float val = dist(generator);
+      if (_verbose.value)
+        std::cout << " valFloat=" << val;
+      *(reinterpret_cast<float*>(datas[i])) = val;
+    }
+    if (_verbose.value)
+      std::cout << ", ";
+    states.push_back(responseState(ids[i]));
+  }
+  if (_verbose.value)
+    std::cout << "}" << std::endl;
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void FakeProtocol::bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                             const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes)
+{
+  if (_verbose.value)
   {
-    output.push_back(ResponseOK);
+    std::cout << "BulkWrite {";
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      std::cout << "id=" << ids[i] << " addr=" << addresses[i] << " size=" << sizes[i];
+      if (sizes[i] == 4)
+      {
+        std::cout << " valFloat=" << *(reinterpret_cast<const float*>(datas[i]));
+      }
+      std::cout << ", ";
+    }
+    std::cout << "}" << std::endl;
   }
-  return output;
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
 void FakeProtocol::emergencyStop()
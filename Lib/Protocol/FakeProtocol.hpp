@@ -22,20 +22,42 @@ public:
   ResponseState writeAndCheckData(id_t id, addr_t address, const uint8_t* data, size_t size);
   ResponseState readData(id_t id, addr_t address, uint8_t* data, size_t size);
   bool ping(id_t id);
-  std::vector<ResponseState> syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas,
-                                      size_t size);
+  void syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas, size_t size,
+                std::vector<ResponseState>& states);
   void syncWrite(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas, size_t size);
-  std::vector<ResponseState> syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
-                                               const std::vector<const uint8_t*>& datas, size_t size);
+  void syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address, const std::vector<const uint8_t*>& datas,
+                         size_t size, std::vector<ResponseState>& states);
+  bool isBulkSupported() const;
+  void bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses, const std::vector<uint8_t*>& datas,
+                const std::vector<size_t>& sizes, std::vector<ResponseState>& states);
+  void bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                 const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes);
   virtual void emergencyStop() override;
   virtual void exitEmergencyState() override;
+  using Protocol::syncRead;
+  using Protocol::syncWriteAndCheck;
+  using Protocol::bulkRead;
+  using Protocol::emergencyStop;
+  using Protocol::exitEmergencyState;
 
 private:
   /**
    * Parameters
    * verbose: enable FakeProtocol display message
+   * quietId: simulated unresponsive device id
+   * (0 for none)
+   * pingAnswer: if true, devices other than
+   * quietId answer to ping
    */
   ParameterBool _verbose;
+  ParameterNumber _quietId;
+  ParameterBool _pingAnswer;
+
+  /**
+   * Return the simulated response state
+   * of given device id
+   */
+  ResponseState responseState(id_t id) const;
 };
 
 }  // namespace RhAL
@@ -1,11 +1,14 @@
 #include <stdexcept>
+#include <limits>
+#include <thread>
+#include <algorithm>
 #include "Protocol.hpp"
 
 using namespace std;
 
 namespace RhAL
 {
-Protocol::Protocol(Bus& bus) : bus(bus), _parametersList()
+Protocol::Protocol(Bus& bus) : bus(bus), _parametersList(), _isPipelined(false), _txQueue(), _txQueueDelay(0.0)
 {
 }
 
@@ -53,6 +56,158 @@ void Protocol::writeWord(id_t id, addr_t address, uint16_t word)
   writeData(id, address, bytes, 2);
 }
 
+bool Protocol::isBulkSupported() const
+{
+  return false;
+}
+
+std::vector<ResponseState> Protocol::syncRead(const std::vector<id_t>& ids, addr_t address,
+                                              const std::vector<uint8_t*>& datas, size_t size)
+{
+  std::vector<ResponseState> states;
+  syncRead(ids, address, datas, size, states);
+  return states;
+}
+
+std::vector<ResponseState> Protocol::syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                                       const std::vector<const uint8_t*>& datas, size_t size)
+{
+  std::vector<ResponseState> states;
+  syncWriteAndCheck(ids, address, datas, size, states);
+  return states;
+}
+
+void Protocol::bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                        const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes,
+                        std::vector<ResponseState>& states)
+{
+  states.resize(ids.size());
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    states[i] = readData(ids[i], addresses[i], datas[i], sizes[i]);
+  }
+}
+
+std::vector<ResponseState> Protocol::bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                                              const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes)
+{
+  std::vector<ResponseState> states;
+  bulkRead(ids, addresses, datas, sizes, states);
+  return states;
+}
+
+void Protocol::bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                         const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes)
+{
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    writeData(ids[i], addresses[i], datas[i], sizes[i]);
+  }
+}
+
+void Protocol::emergencyStop(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses)
+{
+  (void)ids;
+  (void)addresses;
+  emergencyStop();
+}
+
+void Protocol::exitEmergencyState(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses)
+{
+  (void)ids;
+  (void)addresses;
+  exitEmergencyState();
+}
+
+size_t Protocol::maxSyncIds(size_t size) const
+{
+  (void)size;
+  return std::numeric_limits<size_t>::max();
+}
+
+size_t Protocol::transactionOverheadBytes() const
+{
+  return 0;
+}
+
+void Protocol::setPipelined(bool isEnable)
+{
+  if (!isEnable)
+  {
+    sendQueue();
+  }
+  _isPipelined = isEnable;
+}
+
+bool Protocol::isPipelined() const
+{
+  return _isPipelined;
+}
+
+void Protocol::sendRequest(const uint8_t* data, size_t size, bool isResponseExpected)
+{
+  // Pending received bytes are outdated. They
+  // only matter before a request expecting a
+  // response, so writes save the flush call.
+  if (isResponseExpected)
+  {
+    bus.clearInputBuffer();
+  }
+  if (!_isPipelined)
+  {
+    bus.sendData(const_cast<uint8_t*>(data), size);
+    bus.flush();
+  }
+  else if (!isResponseExpected)
+  {
+    _txQueue.insert(_txQueue.end(), data, data + size);
+  }
+  else if (_txQueue.size() > 0 && _txQueueDelay <= 0.0)
+  {
+    // Queued writes and the request
+    // leave in a single gather write
+    struct iovec iov[2] = { { _txQueue.data(), _txQueue.size() }, { const_cast<uint8_t*>(data), size } };
+    bus.sendDataV(iov, 2);
+    bus.flush();
+    _txQueue.clear();
+  }
+  else
+  {
+    // Devices need a delay after
+    // the queued writes
+    sendQueue();
+    bus.sendData(const_cast<uint8_t*>(data), size);
+    bus.flush();
+  }
+}
+
+void Protocol::waitAfterWrite(double delay)
+{
+  if (_isPipelined)
+  {
+    _txQueueDelay = std::max(_txQueueDelay, delay);
+  }
+  else if (delay > 0.0)
+  {
+    std::this_thread::sleep_for(TimeDurationFloat(delay));
+  }
+}
+
+void Protocol::sendQueue()
+{
+  if (_txQueue.size() > 0)
+  {
+    bus.sendData(_txQueue.data(), _txQueue.size());
+    bus.flush();
+    _txQueue.clear();
+    if (_txQueueDelay > 0.0)
+    {
+      std::this_thread::sleep_for(TimeDurationFloat(_txQueueDelay));
+    }
+  }
+  _txQueueDelay = 0.0;
+}
+
 const ParametersList& Protocol::parametersList() const
 {
   return _parametersList;
@@ -76,10 +76,15 @@ public:
   virtual bool ping(id_t id) = 0;
 
   /**
-   * Perform a synchronized read across devices
+   * Perform a synchronized read across devices.
+   * The ResponseState of each device is assigned in
+   * given states container which is resized to ids size.
+   * Reusing the same container avoids heap allocation.
    */
-  virtual std::vector<ResponseState> syncRead(const std::vector<id_t>& ids, addr_t address,
-                                              const std::vector<uint8_t*>& datas, size_t size) = 0;
+  virtual void syncRead(const std::vector<id_t>& ids, addr_t address, const std::vector<uint8_t*>& datas, size_t size,
+                        std::vector<ResponseState>& states) = 0;
+  std::vector<ResponseState> syncRead(const std::vector<id_t>& ids, addr_t address,
+                                      const std::vector<uint8_t*>& datas, size_t size);
 
   /**
    * Performs a synchronized write across devices
@@ -89,9 +94,44 @@ public:
 
   /**
    * Performs a synchronized write and reads the ResponseState of each write
+   * (assigned in given states container)
    */
-  virtual std::vector<ResponseState> syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
-                                                       const std::vector<const uint8_t*>& datas, size_t size) = 0;
+  virtual void syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                 const std::vector<const uint8_t*>& datas, size_t size,
+                                 std::vector<ResponseState>& states) = 0;
+  std::vector<ResponseState> syncWriteAndCheck(const std::vector<id_t>& ids, addr_t address,
+                                               const std::vector<const uint8_t*>& datas, size_t size);
+
+  /**
+   * Return true if the protocol implements bulkRead()
+   * and bulkWrite() as a single transaction
+   */
+  virtual bool isBulkSupported() const;
+
+  /**
+   * Perform a read across devices with a different
+   * address and size for each device.
+   * Each id must appear only once.
+   * Default implementation uses readData() for
+   * each device.
+   * The ResponseState of each device is assigned
+   * in given states container.
+   */
+  virtual void bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                        const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes,
+                        std::vector<ResponseState>& states);
+  std::vector<ResponseState> bulkRead(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                                      const std::vector<uint8_t*>& datas, const std::vector<size_t>& sizes);
+
+  /**
+   * Perform a write across devices with a different
+   * address and size for each device.
+   * Each id must appear only once.
+   * Default implementation uses writeData() for
+   * each device.
+   */
+  virtual void bulkWrite(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses,
+                         const std::vector<const uint8_t*>& datas, const std::vector<size_t>& sizes);
 
   /**
    * Sends a broadcasted signal to put all the devices
@@ -105,6 +145,50 @@ public:
    */
   virtual void exitEmergencyState() = 0;
 
+  /**
+   * Same as above with the ids of the devices
+   * known on the bus and the address of their
+   * torque enable register, for protocols
+   * without a broadcast stop command.
+   * Default implementation ignores them and
+   * uses the broadcast versions.
+   */
+  virtual void emergencyStop(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses);
+  virtual void exitEmergencyState(const std::vector<id_t>& ids, const std::vector<addr_t>& addresses);
+
+  /**
+   * Return the maximum number of devices a single
+   * sync read or sync write frame can hold for given
+   * per device data size. Larger sync operations are
+   * split by the protocol into several frames.
+   * Default is no limit.
+   */
+  virtual size_t maxSyncIds(size_t size) const;
+
+  /**
+   * Return the number of framing bytes (headers,
+   * instruction, checksums) of a single read transaction
+   * (request and response) beside the read data.
+   * Used by the Manager to estimate transaction costs.
+   */
+  virtual size_t transactionOverheadBytes() const;
+
+  /**
+   * Enable or disable the pipelined mode.
+   * When enabled, requests without status response
+   * (writes, sync writes) are queued instead of
+   * being sent one by one. Queued requests are sent
+   * back to back in a single Bus::sendData() call,
+   * ahead of the next request expecting a response
+   * or when the mode is disabled.
+   * The queue and the request leave together in a
+   * single Bus::sendDataV() call only if no delay
+   * is required after the queued writes (protocol
+   * waitAfterWrite parameter set to zero).
+   */
+  void setPipelined(bool isEnable);
+  bool isPipelined() const;
+
   /**
    * Read/Write access to Parameters list
    */
@@ -117,9 +201,42 @@ protected:
    */
   Bus& bus;
 
+  /**
+   * Send given request bytes on the bus
+   * (or queue them in pipelined mode if
+   * no response is expected). The bus input
+   * is cleared before requests expecting
+   * a response only.
+   */
+  void sendRequest(const uint8_t* data, size_t size, bool isResponseExpected);
+
+  /**
+   * Wait given delay in seconds after a write
+   * before talking again to the devices.
+   * In pipelined mode, the wait is postponed
+   * until the queued requests are sent.
+   */
+  void waitAfterWrite(double delay);
+
   /**
    * Protocol parameters
    */
   ParametersList _parametersList;
+
+private:
+  /**
+   * Pipelined mode, queued requests bytes
+   * and the longest wait requested after
+   * the queued writes
+   */
+  bool _isPipelined;
+  std::vector<uint8_t> _txQueue;
+  double _txQueueDelay;
+
+  /**
+   * Send the queued requests if any
+   * and wait the postponed delay
+   */
+  void sendQueue();
 };
 }  // namespace RhAL
@@ -1,5 +1,6 @@
 #include "ProtocolFactory.hpp"
 #include "Protocol/DynamixelV1.hpp"
+#include "Protocol/DynamixelV2.hpp"
 #include "Protocol/FakeProtocol.hpp"
 
 namespace RhAL
@@ -10,6 +11,10 @@ Protocol* ProtocolFactory(const std::string& name, Bus& bus)
   {
     return new DynamixelV1(bus);
   }
+  else if (name == "DynamixelV2")
+  {
+    return new DynamixelV2(bus);
+  }
   else if (name == "FakeProtocol")
   {
     return new FakeProtocol(bus);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <limits>
 
 namespace RhAL
 {
@@ -19,8 +20,8 @@ constexpr id_t IdDevBegin = 1;
 constexpr id_t IdDevEnd = 253;
 
 /**
- * Number of milliseconds that will be waited
- * after writing to a slow register
+ * Number of milliseconds a Device is excluded
+ * from the bus after writing to a slow register
  */
 constexpr unsigned int SlowRegisterDelayMs = 100;
 
@@ -30,6 +31,56 @@ constexpr unsigned int SlowRegisterDelayMs = 100;
  */
 constexpr unsigned int MaxForceReTries = 20;
 
+/**
+ * Number of batch plans kept in cache
+ * for each of read and write operations
+ * (periodic registers lead to a few
+ * alternating registers selections)
+ */
+constexpr size_t BatchPlanCacheSize = 4;
+
+/**
+ * Number of one microsecond buckets of the
+ * Manager scheduler period jitter histogram
+ * (the last bucket holds larger jitters)
+ */
+constexpr size_t SchedulerJitterBuckets = 1000;
+
+/**
+ * Maximum number of flush cycles over which
+ * the periodic reads phases are balanced
+ * (least common multiple of read periods,
+ * truncated if larger)
+ */
+constexpr size_t PeriodicScheduleHorizonMax = 10000;
+
+/**
+ * Read subscription rate asking
+ * for a read at each flush cycle
+ */
+constexpr double ReadEveryCycle = std::numeric_limits<double>::infinity();
+
+/**
+ * Number of flush cycles between two updates
+ * of subscribed Registers read period from
+ * the measured flush rate
+ */
+constexpr unsigned long ReadPeriodUpdateCycles = 100;
+
+/**
+ * Register read priority classes.
+ * Under a flush time budget, high priority
+ * reads are always issued and lower classes
+ * fill the remaining bus time.
+ */
+enum RegisterPriority
+{
+  PriorityHigh = 0,
+  PriorityNormal = 1,
+  PriorityLow = 2,
+};
+constexpr size_t RegisterPriorityCount = 3;
+
 /**
  * Device register address
  */
@@ -0,0 +1,102 @@
+#include <iostream>
+#include "Bus/SerialBus.hpp"
+#include "Bus/NativeSerialBus.hpp"
+#include "Protocol/DynamixelV1.hpp"
+#include "Protocol/DynamixelV1Simulator.hpp"
+#include "tests.h"
+
+/**
+ * Compare the round trip latency of the Bus
+ * implementations with DynamixelV1 pings, sync
+ * reads and (pipelined) writes answered by
+ * simulated devices over a PTY pair.
+ * Byte timing emulation is
+ * disabled so that only the host software
+ * stack is measured.
+ */
+constexpr size_t NbDevices = 12;
+constexpr size_t NbIterations = 2000;
+
+/**
+ * Build the Bus on the simulator port and
+ * print the mean round trip durations
+ */
+template <typename T>
+void bench(const std::string& name)
+{
+  RhAL::DynamixelV1Simulator simulator(0);
+  std::vector<RhAL::id_t> ids;
+  std::vector<uint8_t*> datas;
+  std::vector<uint8_t> buffer(NbDevices * 4);
+  for (size_t i = 0; i < NbDevices; i++)
+  {
+    simulator.addDevice(i + 1);
+    ids.push_back(i + 1);
+    datas.push_back(buffer.data() + i * 4);
+  }
+  T bus(simulator.port(), 1000000);
+  RhAL::DynamixelV1 protocol(bus);
+
+  size_t failures = 0;
+  RhAL::TimePoint start = RhAL::getTimePoint();
+  for (size_t k = 0; k < NbIterations; k++)
+  {
+    if (!protocol.ping(1))
+    {
+      failures++;
+    }
+  }
+  RhAL::TimePoint stop = RhAL::getTimePoint();
+  double duration = RhAL::duration_float(start, stop);
+  std::cout << name << " PTY ping round trip: " << duration / NbIterations * 1e6 << "us/op, " << failures
+            << " failures" << std::endl;
+
+  failures = 0;
+  start = RhAL::getTimePoint();
+  for (size_t k = 0; k < NbIterations; k++)
+  {
+    std::vector<RhAL::ResponseState> states = protocol.syncRead(ids, 0x24, datas, 4);
+    if (!(states.back() & RhAL::ResponseOK))
+    {
+      failures++;
+    }
+  }
+  stop = RhAL::getTimePoint();
+  duration = RhAL::duration_float(start, stop);
+  std::cout << name << " PTY sync read (" << NbDevices << "x4 bytes): " << duration / NbIterations * 1e6
+            << "us/op, " << failures << " failures" << std::endl;
+
+  // Writes without status followed by a
+  // read, sent one by one or pipelined
+  protocol.parametersList().paramNumber("waitAfterWrite").value = 0.0;
+  for (bool isPipelined : { false, true })
+  {
+    protocol.setPipelined(isPipelined);
+    failures = 0;
+    start = RhAL::getTimePoint();
+    for (size_t k = 0; k < NbIterations; k++)
+    {
+      for (size_t i = 0; i < 4; i++)
+      {
+        protocol.writeData(ids[i], 0x1E, datas[i], 2);
+      }
+      if (!(protocol.readData(1, 0x24, datas[0], 4) & RhAL::ResponseOK))
+      {
+        failures++;
+      }
+    }
+    stop = RhAL::getTimePoint();
+    duration = RhAL::duration_float(start, stop);
+    std::cout << name << " PTY 4 writes and read" << (isPipelined ? " (pipelined): " : ": ")
+              << duration / NbIterations * 1e6 << "us/op, " << failures << " failures" << std::endl;
+  }
+  protocol.setPipelined(false);
+}
+
+int main()
+{
+  bench<RhAL::SerialBus>("SerialBus");
+  bench<RhAL::NativeSerialBus>("NativeSerialBus");
+
+  return 0;
+}
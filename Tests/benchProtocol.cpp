@@ -0,0 +1,119 @@
+#include <iostream>
+#include "Protocol/DynamixelV1.hpp"
+#include "Protocol/DynamixelV2.hpp"
+#include "tests.h"
+#include "loopbackBus.h"
+
+/**
+ * Compare encoding and parsing throughput
+ * of Dynamixel protocols on a sync read of
+ * NbDevices registers served by an
+ * in memory bus.
+ */
+constexpr size_t NbDevices = 20;
+constexpr size_t Size = 4;
+constexpr size_t NbIterations = 20000;
+
+/**
+ * Build the Rhoban protocol 1.0 sync read
+ * response (single packet)
+ */
+std::vector<uint8_t> responseV1()
+{
+  std::vector<uint8_t> packet = { 0xFF, 0xFF, 0xFD, (uint8_t)(NbDevices * (Size + 1) + 2), 0x00 };
+  for (size_t i = 0; i < NbDevices; i++)
+  {
+    packet.push_back(0x00);
+    for (size_t j = 0; j < Size; j++)
+    {
+      packet.push_back(i + j);
+    }
+  }
+  uint8_t checksum = 0;
+  for (size_t k = 2; k < packet.size(); k++)
+  {
+    checksum += packet[k];
+  }
+  packet.push_back(~checksum);
+  return packet;
+}
+
+/**
+ * Build the protocol 2.0 sync read
+ * response (one status packet per device)
+ */
+std::vector<uint8_t> responseV2()
+{
+  std::vector<uint8_t> response;
+  for (size_t i = 0; i < NbDevices; i++)
+  {
+    std::vector<uint8_t> packet = { 0xFF, 0xFF, 0xFD, 0x00, (uint8_t)(i + 1), Size + 4, 0x00, 0x55, 0x00 };
+    for (size_t j = 0; j < Size; j++)
+    {
+      packet.push_back(i + j);
+    }
+    uint16_t crc = RhAL::DynamixelV2::computeCRC(0, packet.data(), packet.size());
+    packet.push_back(crc & 0xFF);
+    packet.push_back(crc >> 8);
+    response.insert(response.end(), packet.begin(), packet.end());
+  }
+  return response;
+}
+
+/**
+ * Run the sync read benchmark on given
+ * protocol and print the mean duration
+ */
+void bench(const std::string& name, RhAL::Protocol& protocol, LoopbackBus& bus)
+{
+  std::vector<RhAL::id_t> ids;
+  std::vector<uint8_t*> datas;
+  std::vector<uint8_t> buffer(NbDevices * Size);
+  for (size_t i = 0; i < NbDevices; i++)
+  {
+    ids.push_back(i + 1);
+    datas.push_back(buffer.data() + i * Size);
+  }
+  RhAL::TimePoint start = RhAL::getTimePoint();
+  for (size_t k = 0; k < NbIterations; k++)
+  {
+    std::vector<RhAL::ResponseState> states = protocol.syncRead(ids, 0x24, datas, Size);
+    if (!(states.back() & RhAL::ResponseOK))
+    {
+      throw std::logic_error("Benchmark sync read failed: " + name);
+    }
+  }
+  RhAL::TimePoint stop = RhAL::getTimePoint();
+  assertEquals(buffer[(NbDevices - 1) * Size], (uint8_t)(NbDevices - 1));
+  double duration = RhAL::duration_float(start, stop);
+  std::cout << name << " sync read (" << NbDevices << "x" << Size << " bytes, " << bus.response.size()
+            << " response bytes): " << duration / NbIterations * 1e6 << "us/op, "
+            << NbIterations * bus.response.size() / duration / 1e6 << "MB/s parsed" << std::endl;
+}
+
+int main()
+{
+  LoopbackBus busV1;
+  busV1.response = responseV1();
+  RhAL::DynamixelV1 protocolV1(busV1);
+  bench("DynamixelV1", protocolV1, busV1);
+
+  LoopbackBus busV2;
+  busV2.response = responseV2();
+  RhAL::DynamixelV2 protocolV2(busV2);
+  bench("DynamixelV2", protocolV2, busV2);
+
+  // Raw CRC throughput
+  std::vector<uint8_t> data(1024, 0x5A);
+  uint16_t crc = 0;
+  RhAL::TimePoint start = RhAL::getTimePoint();
+  for (size_t k = 0; k < NbIterations; k++)
+  {
+    crc = RhAL::DynamixelV2::computeCRC(crc, data.data(), data.size());
+  }
+  RhAL::TimePoint stop = RhAL::getTimePoint();
+  std::cout << "DynamixelV2 CRC16: " << NbIterations * data.size() / RhAL::duration_float(start, stop) / 1e6
+            << "MB/s (" << crc << ")" << std::endl;
+
+  return 0;
+}
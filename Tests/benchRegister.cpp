@@ -0,0 +1,252 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstring>
+#include "Manager/Register.hpp"
+#include "Manager/CallManager.hpp"
+#include "tests.h"
+
+/**
+ * Measure Register readValue() latency from
+ * user threads while a Manager like thread
+ * continuously reads and swaps all Registers.
+ * A baseline Register locking a mutex on each
+ * access (as Register did before its lock free
+ * read path) is measured under the same load.
+ */
+constexpr size_t NbRegisters = 200;
+constexpr size_t NbReaders = 3;
+constexpr double Duration = 1.0;
+
+/**
+ * Minimal Manager never called
+ * in schedule mode
+ */
+class BenchManager : public RhAL::CallManager
+{
+public:
+  void onNewRegister(RhAL::id_t id, const std::string& name) override
+  {
+    (void)id;
+    (void)name;
+  }
+  void forceRegisterRead(RhAL::id_t id, const std::string& name) override
+  {
+    (void)id;
+    (void)name;
+  }
+  void forceRegisterWrite(RhAL::id_t id, const std::string& name) override
+  {
+    (void)id;
+    (void)name;
+  }
+  bool isDeviceDontRead(RhAL::id_t id) override
+  {
+    (void)id;
+    return false;
+  }
+};
+
+/**
+ * Register exposing Manager side operations
+ */
+class BenchRegister : public RhAL::TypedRegisterFloat
+{
+public:
+  BenchRegister()
+    : RhAL::TypedRegisterFloat(
+          "bench", 0, 4, [](RhAL::data_t* data, float value) { memcpy(data, &value, sizeof(float)); },
+          [](const RhAL::data_t* data) -> float {
+            float value;
+            memcpy(&value, data, sizeof(float));
+            return value;
+          },
+          1)
+  {
+  }
+  void managerRead(const RhAL::TimePoint& timestamp, float value)
+  {
+    if (needRead() || periodPackedRead > 0)
+    {
+      readyForRead();
+      memcpy(_dataBufferRead, &value, sizeof(float));
+      finishRead(timestamp);
+    }
+  }
+  void managerSwap()
+  {
+    swapRead();
+  }
+};
+
+/**
+ * Baseline Register with the mutex
+ * locked read path of the previous
+ * Register implementation
+ */
+class LockedRegister
+{
+public:
+  LockedRegister()
+    : _mutex()
+    , _needRead(true)
+    , _needSwaping(false)
+    , _isLastReadError(false)
+    , _dataBufferRead()
+    , _valueRead(0.0f)
+    , _lastDevReadManager()
+    , _lastDevReadUser()
+  {
+  }
+  void managerRead(const RhAL::TimePoint& timestamp, float value)
+  {
+    if (needRead())
+    {
+      readyForRead();
+      memcpy(_dataBufferRead, &value, sizeof(float));
+      finishRead(timestamp);
+    }
+  }
+  void managerSwap()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_needSwaping)
+    {
+      return;
+    }
+    _needSwaping = false;
+    _isLastReadError = false;
+    memcpy(&_valueRead, _dataBufferRead, sizeof(float));
+    _lastDevReadUser = _lastDevReadManager;
+    _needRead = true;
+  }
+  RhAL::ReadValueFloat readValue()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return RhAL::ReadValueFloat(_lastDevReadUser, _valueRead, _isLastReadError);
+  }
+
+private:
+  bool needRead()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _needRead;
+  }
+  void readyForRead()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _needRead = false;
+  }
+  void finishRead(const RhAL::TimePoint& timestamp)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _needSwaping = true;
+    _lastDevReadManager = timestamp;
+  }
+
+  std::mutex _mutex;
+  bool _needRead;
+  bool _needSwaping;
+  bool _isLastReadError;
+  RhAL::data_t _dataBufferRead[4];
+  float _valueRead;
+  RhAL::TimePoint _lastDevReadManager;
+  RhAL::TimePoint _lastDevReadUser;
+};
+
+/**
+ * Run the Manager like thread and the
+ * reader threads on given Registers
+ * and print the results
+ */
+template <typename T>
+void runBench(const std::string& label, std::vector<std::unique_ptr<T>>& registers)
+{
+  std::atomic<bool> isRunning(true);
+  // Manager like thread
+  unsigned long cycles = 0;
+  std::thread managerThread([&]() {
+    while (isRunning)
+    {
+      RhAL::TimePoint now = RhAL::getTimePoint();
+      for (size_t i = 0; i < NbRegisters; i++)
+      {
+        registers[i]->managerSwap();
+      }
+      for (size_t i = 0; i < NbRegisters; i++)
+      {
+        registers[i]->managerRead(now, (float)cycles);
+      }
+      cycles++;
+    }
+  });
+  // User reader threads
+  std::vector<unsigned long> counts(NbReaders, 0);
+  std::vector<double> maxLatencies(NbReaders, 0.0);
+  std::vector<std::thread> readers;
+  for (size_t k = 0; k < NbReaders; k++)
+  {
+    readers.emplace_back([&, k]() {
+      while (isRunning)
+      {
+        RhAL::TimePoint start = RhAL::getTimePoint();
+        for (size_t i = 0; i < NbRegisters; i++)
+        {
+          RhAL::ReadValueFloat value = registers[i]->readValue();
+          if (value.value < 0.0f)
+          {
+            throw std::logic_error("Benchmark invalid read value");
+          }
+        }
+        double latency = RhAL::duration_float(start, RhAL::getTimePoint());
+        if (latency > maxLatencies[k])
+        {
+          maxLatencies[k] = latency;
+        }
+        counts[k] += NbRegisters;
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(Duration));
+  isRunning = false;
+  managerThread.join();
+  unsigned long count = 0;
+  double maxLatency = 0.0;
+  for (size_t k = 0; k < NbReaders; k++)
+  {
+    readers[k].join();
+    count += counts[k];
+    maxLatency = std::max(maxLatency, maxLatencies[k]);
+  }
+  assertEquals(cycles > 0, true);
+  std::cout << label << " readValue() with " << NbReaders << " readers: " << Duration * NbReaders / count * 1e9
+            << "ns/op, max " << maxLatency * 1e6 << "us for all registers" << std::endl;
+  std::cout << label << " Manager cycle over " << NbRegisters << " registers: " << Duration / cycles * 1e6 << "us"
+            << std::endl;
+}
+
+int main()
+{
+  BenchManager manager;
+  std::vector<std::unique_ptr<BenchRegister>> registers;
+  std::vector<RhAL::data_t> buffers(NbRegisters * 2 * 4);
+  for (size_t i = 0; i < NbRegisters; i++)
+  {
+    registers.emplace_back(new BenchRegister());
+    registers.back()->init(1, &manager, &buffers[i * 8], &buffers[i * 8 + 4]);
+  }
+  std::vector<std::unique_ptr<LockedRegister>> lockedRegisters;
+  for (size_t i = 0; i < NbRegisters; i++)
+  {
+    lockedRegisters.emplace_back(new LockedRegister());
+  }
+
+  runBench("Register (lock free)", registers);
+  runBench("Baseline (mutex)", lockedRegisters);
+
+  return 0;
+}
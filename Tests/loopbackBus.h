@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <string.h>
+#include "Bus/Bus.hpp"
+
+/**
+ * LoopbackBus
+ *
+ * In memory Bus for protocol tests.
+ * Last sent bytes, all sent packets if
+ * isRecording is set (and the number of
+ * sendData() calls) are stored and the
+ * preset response bytes are served
+ * back after each sendData() call.
+ */
+class LoopbackBus : public RhAL::Bus
+{
+public:
+  std::vector<uint8_t> sent;
+  std::vector<std::vector<uint8_t>> packets;
+  bool isRecording;
+  std::vector<uint8_t> response;
+  size_t position;
+  size_t sendCount;
+
+  LoopbackBus() : sent(), packets(), isRecording(false), response(), position(0), sendCount(0)
+  {
+  }
+
+  bool sendData(uint8_t* data, size_t size)
+  {
+    sent.assign(data, data + size);
+    if (isRecording)
+    {
+      packets.push_back(sent);
+    }
+    sendCount++;
+    position = 0;
+    return true;
+  }
+  bool waitForData(double timeout)
+  {
+    (void)timeout;
+    return position < response.size();
+  }
+  size_t readData(uint8_t* data, size_t size)
+  {
+    size_t n = std::min(size, response.size() - position);
+    memcpy(data, response.data() + position, n);
+    position += n;
+    return n;
+  }
+  void flush()
+  {
+  }
+  void clearInputBuffer()
+  {
+  }
+  size_t available()
+  {
+    return response.size() - position;
+  }
+};
@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <new>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+#include "Protocol/DynamixelV1.hpp"
+#include "loopbackBus.h"
+
+/**
+ * Count heap allocations
+ * when enabled
+ */
+static bool isCounting = false;
+static size_t allocationCount = 0;
+
+/**
+ * Not inlined so that the compiler does not
+ * pair free() with new expressions
+ */
+__attribute__((noinline)) static void releaseMemory(void* ptr)
+{
+  free(ptr);
+}
+
+void* operator new(size_t size)
+{
+  if (isCounting)
+  {
+    allocationCount++;
+  }
+  void* ptr = malloc(size);
+  if (ptr == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void operator delete(void* ptr) noexcept
+{
+  releaseMemory(ptr);
+}
+void operator delete(void* ptr, size_t size) noexcept
+{
+  (void)size;
+  releaseMemory(ptr);
+}
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+
+  // Warm up until all batch
+  // plans are cached
+  for (size_t i = 0; i < 8; i++)
+  {
+    manager.dev<RhAL::ExampleDevice1>("dev1").goal().writeValue(1.0);
+    manager.dev<RhAL::ExampleDevice1>("dev2").goal().writeValue(2.0);
+    manager.flush();
+  }
+
+  // Steady state flushes with sync
+  // read and sync write do not allocate
+  isCounting = true;
+  for (size_t i = 0; i < 100; i++)
+  {
+    manager.dev<RhAL::ExampleDevice1>("dev1").goal().writeValue(1.0);
+    manager.dev<RhAL::ExampleDevice1>("dev2").goal().writeValue(2.0);
+    manager.flush();
+  }
+  isCounting = false;
+  assertEquals(allocationCount, (size_t)0);
+
+  // DynamixelV1 sync read packets use
+  // fixed capacity buffers
+  LoopbackBus bus;
+  RhAL::DynamixelV1 protocol(bus);
+  std::vector<RhAL::id_t> ids = { 1, 2 };
+  uint8_t data1[2];
+  uint8_t data2[2];
+  std::vector<uint8_t*> datas = { data1, data2 };
+  std::vector<RhAL::ResponseState> states;
+  bus.response = { 0xFF, 0xFF, 0xFD, 2 + 6, 0x00, 0x00, 0x01, 0x02, 0x00, 0x03, 0x04 };
+  uint8_t checksum = 0;
+  for (size_t i = 2; i < bus.response.size(); i++)
+  {
+    checksum += bus.response[i];
+  }
+  bus.response.push_back(~checksum);
+  protocol.syncRead(ids, 0x24, datas, 2, states);
+  allocationCount = 0;
+  isCounting = true;
+  for (size_t i = 0; i < 100; i++)
+  {
+    protocol.syncRead(ids, 0x24, datas, 2, states);
+  }
+  isCounting = false;
+  assertEquals(allocationCount, (size_t)0);
+  assertEquals(states[0], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(data2[1], (uint8_t)0x04);
+
+  return 0;
+}
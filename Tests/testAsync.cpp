@@ -0,0 +1,97 @@
+#include <chrono>
+#include <future>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+#include "Devices/MX64.hpp"
+
+/**
+ * Return true if given future is ready
+ */
+template <typename T>
+static bool isReady(std::future<T>& future)
+{
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1, RhAL::MX64> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::MX64>(2, "dev2");
+  RhAL::ExampleDevice1& dev1 = manager.dev<RhAL::ExampleDevice1>("dev1");
+  RhAL::MX64& dev2 = manager.dev<RhAL::MX64>("dev2");
+  manager.flush();
+
+  // Reads are completed at next flush
+  std::future<RhAL::ReadValueFloat> position = dev1.position().readAsync();
+  std::future<RhAL::ReadValueFloat> goal = dev1.goal().readAsync();
+  assertEquals(isReady(position), false);
+  assertEquals(isReady(goal), false);
+  manager.flush();
+  assertEquals(isReady(position), true);
+  assertEquals(isReady(goal), true);
+  assertEquals(position.get().isError, false);
+  assertEquals(goal.get().isError, false);
+
+  // Force read Registers do not block
+  manager.resetStatistics();
+  int count = 0;
+  dev2.temperature().readAsync([&count](RhAL::ReadValueInt value) {
+    assertEquals(value.isError, false);
+    count++;
+  });
+  assertEquals(count, 0);
+  manager.flush();
+  assertEquals(count, 1);
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.forceReadCount, (unsigned long)0);
+
+  // Writes are completed once issued
+  manager.resetStatistics();
+  std::future<bool> written = dev1.goal().writeAsync(2.0);
+  std::future<bool> writtenForce = dev2.goalPosition().writeAsync(10.0);
+  assertEquals(isReady(written), false);
+  assertEquals(isReady(writtenForce), false);
+  assertEquals(dev1.goal().getWrittenValue(), 2.0f);
+  manager.flush();
+  assertEquals(isReady(written), true);
+  assertEquals(isReady(writtenForce), true);
+  assertEquals(written.get(), true);
+  assertEquals(writtenForce.get(), true);
+  stats = manager.getStatistics();
+  assertEquals(stats.forceWriteCount, (unsigned long)0);
+  assertEquals(stats.writeCount, (unsigned long)2);
+
+  // Reads of quarantined Devices are
+  // completed with the read error
+  manager.setQuarantineFailures(1);
+  manager.protocolParametersList().paramNumber("quietId").value = 1;
+  manager.protocolParametersList().paramBool("pingAnswer").value = false;
+  manager.flush();
+  manager.flush();
+  assertEquals(dev1.isQuarantined(), true);
+  position = dev1.position().readAsync();
+  assertEquals(isReady(position), false);
+  manager.flush();
+  assertEquals(isReady(position), true);
+  assertEquals(position.get().isError, true);
+  manager.protocolParametersList().paramNumber("quietId").value = 0;
+
+  // Devices never read complete at once
+  dev2.parametersList().paramBool("dontRead").value = true;
+  std::future<RhAL::ReadValueInt> temperature = dev2.temperature().readAsync();
+  assertEquals(isReady(temperature), true);
+  assertEquals(temperature.get().isError, true);
+  dev2.parametersList().paramBool("dontRead").value = false;
+
+  // Immediate mode completes before returning
+  manager.setScheduleMode(false);
+  position = dev1.position().readAsync();
+  assertEquals(isReady(position), true);
+  written = dev1.goal().writeAsync(3.0);
+  assertEquals(isReady(written), true);
+  assertEquals(written.get(), true);
+
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <thread>
+#include <chrono>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/MX64.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::MX64> manager;
+  manager.devAdd<RhAL::MX64>(1, "dev1");
+  manager.devAdd<RhAL::MX64>(2, "dev2");
+  manager.addBackgroundRead(1, "temperature");
+  manager.addBackgroundRead(2, "temperature");
+  manager.addBackgroundRead(2, "voltage");
+  // Added once
+  manager.addBackgroundRead(2, "voltage");
+
+  // Free running mode has no idle time
+  manager.resetStatistics();
+  manager.startManagerThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  manager.stopManagerThread();
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.backgroundReadCount, (unsigned long)0);
+
+  // At 50Hz, the three reads fit
+  // in idle time of each cycle
+  manager.setSchedulerConfig(50.0);
+  manager.resetStatistics();
+  manager.startManagerThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  manager.stopManagerThread();
+  stats = manager.getStatistics();
+  assertEquals(stats.backgroundReadCount >= 3 * (stats.schedulerPeriodCount - 1), true);
+  assertEquals(stats.backgroundReadCount <= 3 * stats.schedulerPeriodCount, true);
+  assertEquals(stats.backgroundReadErrorCount, (unsigned long)0);
+  assertEquals(stats.schedulerDeadlineMissCount, (unsigned long)0);
+
+  // Values are published at flush without
+  // any force read by the user
+  manager.flush();
+  manager.resetStatistics();
+  RhAL::ReadValueInt value = manager.dev<RhAL::MX64>("dev1").temperature().readValue();
+  assertEquals(value.isError, false);
+  stats = manager.getStatistics();
+  assertEquals(stats.forceReadCount, (unsigned long)0);
+
+  // Removed Registers are force read again
+  manager.removeBackgroundRead(1, "temperature");
+  manager.dev<RhAL::MX64>("dev1").temperature().readValue();
+  stats = manager.getStatistics();
+  assertEquals(stats.forceReadCount, (unsigned long)1);
+
+  return 0;
+}
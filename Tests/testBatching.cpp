@@ -0,0 +1,63 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+#include "Devices/ExampleDevice2.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.setStaggerPeriodicReads(false);
+
+  // Position is read every cycle and temperature
+  // every 4 cycles at the same cycle for all
+  // Devices. Two read plans and one (empty)
+  // write plan are expected to be built.
+  for (size_t i = 0; i < 12; i++)
+  {
+    manager.flush();
+  }
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.batchPlanRebuildCount, (unsigned long)3);
+  assertEquals(stats.batchPlanReuseCount, (unsigned long)21);
+
+  // A new write selection leads to a new plan
+  manager.dev<RhAL::ExampleDevice1>("dev1").goal().writeValue(1.0);
+  manager.dev<RhAL::ExampleDevice1>("dev2").goal().writeValue(2.0);
+  manager.flush();
+  stats = manager.getStatistics();
+  assertEquals(stats.batchPlanRebuildCount, (unsigned long)4);
+
+  // With gap read enabled, position and temperature
+  // (separated by 4 bytes) are read in one sync read
+  manager.setEnableGapRead(true);
+  manager.resetStatistics();
+  for (size_t i = 0; i < 4; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  assertEquals(stats.syncReadCount, (unsigned long)4);
+  assertEquals(stats.gapReadLength, (unsigned long)3 * 4);
+
+  // With bulk read enabled, registers at different
+  // addresses on different devices are read in a
+  // single bulk read per flush
+  RhAL::Manager<RhAL::ExampleDevice1, RhAL::ExampleDevice2> managerBulk;
+  managerBulk.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  managerBulk.devAdd<RhAL::ExampleDevice2>(2, "dev2");
+  managerBulk.setEnableGapRead(true);
+  managerBulk.setEnableBulkRead(true);
+  for (size_t i = 0; i < 4; i++)
+  {
+    managerBulk.flush();
+  }
+  stats = managerBulk.getStatistics();
+  assertEquals(stats.bulkReadCount, (unsigned long)4);
+  assertEquals(stats.syncReadCount, (unsigned long)0);
+  assertEquals(stats.readCount, (unsigned long)0);
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+#include "Devices/RX64.hpp"
+
+/**
+ * Run given function concurrently
+ * on the four test Devices
+ * (count times in each thread)
+ */
+static void runConcurrently(RhAL::Manager<RhAL::ExampleDevice1>& manager,
+                            std::function<void(RhAL::ExampleDevice1&)> func, unsigned int count = 1)
+{
+  std::vector<std::thread> threads;
+  for (RhAL::id_t id = 1; id <= 4; id++)
+  {
+    RhAL::ExampleDevice1& dev = manager.dev<RhAL::ExampleDevice1>(id);
+    threads.push_back(std::thread([&dev, func, count]() {
+      for (unsigned int i = 0; i < count; i++)
+      {
+        func(dev);
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+}
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.devAdd<RhAL::ExampleDevice1>(4, "dev4");
+  // Immediate mode, all accesses are forced
+  manager.setScheduleMode(false);
+
+  // Without coalescing, each
+  // read is a single transaction
+  manager.resetStatistics();
+  runConcurrently(manager, [](RhAL::ExampleDevice1& dev) { dev.position().readValue(); });
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.readCount, (unsigned long)4);
+  assertEquals(stats.syncReadCount, (unsigned long)0);
+
+  // Concurrent reads of a same address
+  // are merged into sync reads
+  manager.setForceCoalesceWindow(50000.0);
+  manager.resetStatistics();
+  runConcurrently(
+      manager,
+      [](RhAL::ExampleDevice1& dev) {
+        RhAL::ReadValueFloat value = dev.position().readValue();
+        assertEquals(value.isError, false);
+      },
+      50);
+  stats = manager.getStatistics();
+  assertEquals(stats.forceReadCount, (unsigned long)200);
+  assertEquals(stats.readCount + stats.forceCoalescedCount, (unsigned long)200);
+  assertEquals(stats.forceCoalescedCount > 0, true);
+  assertEquals(stats.syncReadCount > 0, true);
+
+  // Same for writes
+  manager.resetStatistics();
+  runConcurrently(manager, [](RhAL::ExampleDevice1& dev) { dev.goal().writeValue(1.0); }, 50);
+  stats = manager.getStatistics();
+  assertEquals(stats.forceWriteCount, (unsigned long)200);
+  assertEquals(stats.writeCount + stats.forceCoalescedCount, (unsigned long)200);
+  assertEquals(stats.forceCoalescedCount > 0, true);
+  assertEquals(stats.syncWriteCount > 0, true);
+
+  // A lone request is issued
+  // alone without waiting
+  manager.resetStatistics();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  manager.dev<RhAL::ExampleDevice1>(1).position().readValue();
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+  stats = manager.getStatistics();
+  assertEquals(stats.readCount, (unsigned long)1);
+  assertEquals(stats.forceCoalescedCount, (unsigned long)0);
+  assertEquals(elapsed < std::chrono::milliseconds(25), true);
+
+  // A call waiting for the end of a slow
+  // register write is not in flight and
+  // does not delay other requests
+  RhAL::Manager<RhAL::RX64> managerSlow;
+  managerSlow.devAdd<RhAL::RX64>(1, "dev1");
+  managerSlow.devAdd<RhAL::RX64>(2, "dev2");
+  managerSlow.setScheduleMode(false);
+  managerSlow.setForceCoalesceWindow(50000.0);
+  managerSlow.dev<RhAL::RX64>(1).temperatureLimit().writeValue(70);
+  assertEquals(managerSlow.dev(1).isBusy(), true);
+  managerSlow.resetStatistics();
+  std::thread blocked([&managerSlow]() { managerSlow.dev<RhAL::RX64>(1).position().readValue(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  start = std::chrono::steady_clock::now();
+  managerSlow.dev<RhAL::RX64>(2).position().readValue();
+  elapsed = std::chrono::steady_clock::now() - start;
+  blocked.join();
+  stats = managerSlow.getStatistics();
+  assertEquals(stats.forceReadCount, (unsigned long)2);
+  assertEquals(stats.forceCoalescedCount, (unsigned long)0);
+  assertEquals(elapsed < std::chrono::milliseconds(25), true);
+
+  return 0;
+}
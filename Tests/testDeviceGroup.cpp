@@ -0,0 +1,101 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.devAdd<RhAL::ExampleDevice1>(4, "dev4");
+  RhAL::DeviceGroup& group = manager.addDeviceGroup({ 4, 2, 3, 1 }, "goal");
+  assertEquals(group.size(), (size_t)4);
+  assertEquals(group.ids()[0], (RhAL::id_t)4);
+  manager.flush();
+
+  // All values are sent in one sync write
+  manager.resetStatistics();
+  group.writeValues({ 1.0, 2.0, 3.0, 4.0 });
+  assertEquals(group.needWrite(), true);
+  manager.flush();
+  assertEquals(group.needWrite(), false);
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.deviceGroupWriteCount, (unsigned long)1);
+  assertEquals(stats.syncWriteCount, (unsigned long)1);
+  assertEquals(stats.writeCount, (unsigned long)0);
+  assertEquals(stats.regWrittenPerFlushAccu, (unsigned long)4);
+  // Registers are bypassed
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(1).goal().needWrite(), false);
+
+  // Nothing is sent without new values,
+  // last values are sent once
+  manager.resetStatistics();
+  manager.flush();
+  group.writeValues({ 1.0, 2.0, 3.0, 4.0 });
+  group.writeValues({ 5.0, 6.0, 7.0, 8.0 });
+  manager.flush();
+  stats = manager.getStatistics();
+  assertEquals(stats.deviceGroupWriteCount, (unsigned long)1);
+
+  // Without sync write, each Device is written
+  manager.setEnableSyncWrite(false);
+  manager.resetStatistics();
+  group.writeValues({ 1.0, 2.0, 3.0, 4.0 });
+  manager.flush();
+  stats = manager.getStatistics();
+  assertEquals(stats.deviceGroupWriteCount, (unsigned long)1);
+  assertEquals(stats.syncWriteCount, (unsigned long)0);
+  assertEquals(stats.writeCount, (unsigned long)4);
+  manager.setEnableSyncWrite(true);
+
+  // Values of quarantined Devices are
+  // kept until they are readmitted
+  manager.setQuarantineFailures(1);
+  manager.protocolParametersList().paramNumber("quietId").value = 1;
+  manager.flush();
+  manager.flush();
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(1).isQuarantined(), true);
+  manager.resetStatistics();
+  group.writeValues({ 1.0, 2.0, 3.0, 4.0 });
+  manager.flush();
+  assertEquals(group.needWrite(), true);
+  stats = manager.getStatistics();
+  assertEquals(stats.regWrittenPerFlushAccu, (unsigned long)3);
+  manager.protocolParametersList().paramNumber("quietId").value = 0;
+  manager.protocolParametersList().paramBool("pingAnswer").value = true;
+  while (manager.dev<RhAL::ExampleDevice1>(1).isQuarantined())
+  {
+    manager.flush();
+  }
+  manager.resetStatistics();
+  manager.flush();
+  assertEquals(group.needWrite(), false);
+  stats = manager.getStatistics();
+  assertEquals(stats.deviceGroupWriteCount, (unsigned long)1);
+  assertEquals(stats.regWrittenPerFlushAccu, (unsigned long)1);
+
+  // Invalid groups and values
+  bool isThrown = false;
+  try
+  {
+    group.writeValues({ 1.0, 2.0 });
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+  isThrown = false;
+  try
+  {
+    manager.addDeviceGroup({ 1, 2 }, "unknown");
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include <thread>
+#include "Manager/DirtySet.hpp"
+#include "tests.h"
+
+int main()
+{
+  RhAL::DirtySet set;
+  set.resize(200);
+  assertEquals(set.size(), (size_t)200);
+
+  // Indexes are extracted once
+  // in increasing order
+  set.insert(130);
+  set.insert(3);
+  set.insert(64);
+  set.insert(3);
+  set.insert(500);
+  std::vector<size_t> indexes;
+  set.extract(indexes);
+  assertEquals(indexes.size(), (size_t)3);
+  assertEquals(indexes[0], (size_t)3);
+  assertEquals(indexes[1], (size_t)64);
+  assertEquals(indexes[2], (size_t)130);
+  indexes.clear();
+  set.extract(indexes);
+  assertEquals(indexes.size(), (size_t)0);
+
+  // Concurrent insertions are not lost
+  std::vector<std::thread> threads;
+  for (size_t k = 0; k < 4; k++)
+  {
+    threads.emplace_back([&set, k]() {
+      for (size_t i = k; i < 200; i += 4)
+      {
+        set.insert(i);
+      }
+    });
+  }
+  for (size_t k = 0; k < threads.size(); k++)
+  {
+    threads[k].join();
+  }
+  set.extract(indexes);
+  assertEquals(indexes.size(), (size_t)200);
+  assertEquals(indexes.back(), (size_t)199);
+
+  return 0;
+}
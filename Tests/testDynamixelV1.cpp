@@ -0,0 +1,120 @@
+#include "Protocol/DynamixelV1.hpp"
+#include "tests.h"
+#include "loopbackBus.h"
+
+/**
+ * Build a protocol 1.0 status packet
+ */
+std::vector<uint8_t> statusPacket(uint8_t id, uint8_t error, const std::vector<uint8_t>& params)
+{
+  std::vector<uint8_t> packet = { 0xFF, 0xFF, id, (uint8_t)(params.size() + 2), error };
+  packet.insert(packet.end(), params.begin(), params.end());
+  uint8_t checksum = 0;
+  for (size_t i = 2; i < packet.size(); i++)
+  {
+    checksum += packet[i];
+  }
+  packet.push_back(~checksum);
+  return packet;
+}
+
+/**
+ * Expose the frame parser
+ */
+class DynamixelV1Test : public RhAL::DynamixelV1
+{
+public:
+  using RhAL::DynamixelV1::DynamixelV1;
+  using RhAL::DynamixelV1::receivePacket;
+};
+
+int main()
+{
+  LoopbackBus bus;
+  DynamixelV1Test protocol(bus);
+  uint8_t data[2] = { 0 };
+
+  // Read with garbage and a fake header
+  // (bad checksum) before the response
+  bus.response = { 0x12, 0xFF, 0xFF, 0x03, 0x04 };
+  std::vector<uint8_t> status = statusPacket(3, 0x00, { 0x34, 0x12 });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  assertEquals(protocol.readData(3, 0x24, data, 2), (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(data[0], (uint8_t)0x34);
+  assertEquals(data[1], (uint8_t)0x12);
+
+  // A valid frame starting inside an incomplete
+  // frame candidate is found
+  bus.response = { 0xFF, 0xFF, 0x07, 0x40 };
+  status = statusPacket(3, 0x00, { 0x56, 0x78 });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  assertEquals(protocol.readData(3, 0x24, data, 2), (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(data[0], (uint8_t)0x56);
+
+  // Response from another device
+  bus.response = statusPacket(4, 0x00, { 0x00, 0x00 });
+  assertEquals(protocol.readData(3, 0x24, data, 2), (RhAL::ResponseState)RhAL::ResponseBadId);
+
+  // Corrupted response
+  bus.response = statusPacket(3, 0x00, { 0x00, 0x00 });
+  bus.response[5]++;
+  assertEquals(protocol.readData(3, 0x24, data, 2), (RhAL::ResponseState)RhAL::ResponseBadChecksum);
+
+  // Device status
+  bus.response = statusPacket(3, 0x20 | 0x04, { 0x00, 0x00 });
+  assertEquals(protocol.readData(3, 0x24, data, 2),
+               (RhAL::ResponseState)(RhAL::ResponseOK | RhAL::ResponseOverload | RhAL::ResponseOverheat));
+
+  // Bytes following a frame are
+  // kept for the next reception
+  bus.response = statusPacket(1, 0x00, { 0x01 });
+  status = statusPacket(2, 0x00, { 0x02, 0x03 });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  bus.position = 0;
+  const uint8_t* parameters;
+  size_t size;
+  assertEquals(protocol.receivePacket(1, parameters, size), (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(size, (size_t)1);
+  assertEquals(parameters[0], (uint8_t)0x01);
+  assertEquals(bus.available(), (size_t)0);
+  assertEquals(protocol.receivePacket(2, parameters, size), (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(size, (size_t)2);
+  assertEquals(parameters[1], (uint8_t)0x03);
+
+  // Sync write of 30 devices with 8 bytes
+  // each is split into two balanced frames
+  std::vector<RhAL::id_t> ids;
+  std::vector<uint8_t> buffer(30 * 8, 0x00);
+  std::vector<const uint8_t*> datasWrite;
+  std::vector<uint8_t*> datasRead;
+  for (size_t i = 0; i < 30; i++)
+  {
+    ids.push_back(i + 1);
+    datasWrite.push_back(buffer.data() + 8 * i);
+    datasRead.push_back(buffer.data() + 8 * i);
+  }
+  assertEquals(protocol.maxSyncIds(8), (size_t)27);
+  bus.response.clear();
+  bus.sendCount = 0;
+  protocol.syncWrite(ids, 0x1E, datasWrite, 8);
+  // Both frames leave in a single transfer
+  assertEquals(bus.sendCount, (size_t)1);
+  assertEquals(bus.sent.size(), (size_t)(2 * (6 + 2 + 15 * 9)));
+  assertEquals(bus.sent[7], (uint8_t)1);
+  assertEquals(bus.sent[6 + 2 + 15 * 9 + 7], (uint8_t)16);
+
+  // Sync read is split the same way
+  std::vector<uint8_t> response(15 * 9, 0x00);
+  response[14 * 9 + 8] = 0x42;
+  bus.response = statusPacket(0xFD, 0x00, response);
+  bus.sendCount = 0;
+  std::vector<RhAL::ResponseState> states;
+  protocol.syncRead(ids, 0x24, datasRead, 8, states);
+  assertEquals(bus.sendCount, (size_t)2);
+  assertEquals(states.size(), (size_t)30);
+  assertEquals(states[29], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(buffer[14 * 8 + 7], (uint8_t)0x42);
+  assertEquals(buffer[29 * 8 + 7], (uint8_t)0x42);
+
+  return 0;
+}
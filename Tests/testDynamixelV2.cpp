@@ -0,0 +1,198 @@
+#include <cstdlib>
+#include "Protocol/DynamixelV2.hpp"
+#include "tests.h"
+#include "loopbackBus.h"
+
+/**
+ * Build a protocol 2.0 status packet
+ * with byte stuffing and CRC
+ */
+std::vector<uint8_t> statusPacket(uint8_t id, uint8_t error, const std::vector<uint8_t>& params)
+{
+  std::vector<uint8_t> packet = { 0xFF, 0xFF, 0xFD, 0x00, id, 0x00, 0x00, 0x55, error };
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    packet.push_back(params[i]);
+    size_t n = packet.size();
+    if (params[i] == 0xFD && packet[n - 2] == 0xFF && packet[n - 3] == 0xFF)
+    {
+      packet.push_back(0xFD);
+    }
+  }
+  size_t length = packet.size() - 7 + 2;
+  packet[5] = length & 0xFF;
+  packet[6] = (length >> 8) & 0xFF;
+  uint16_t crc = RhAL::DynamixelV2::computeCRC(0, packet.data(), packet.size());
+  packet.push_back(crc & 0xFF);
+  packet.push_back(crc >> 8);
+  return packet;
+}
+
+int main()
+{
+  // Reference ping instruction packet
+  // from the protocol documentation
+  std::vector<uint8_t> ping = { 0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01 };
+  assertEquals(RhAL::DynamixelV2::computeCRC(0, ping.data(), ping.size()), (uint16_t)0x4E19);
+
+  // Slicing-by-8 and byte per byte CRC agree
+  std::vector<uint8_t> random;
+  for (size_t i = 0; i < 1000; i++)
+  {
+    random.push_back(std::rand() & 0xFF);
+  }
+  for (size_t len = 0; len < random.size(); len += 7)
+  {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+      crc = RhAL::DynamixelV2::computeCRC(crc, random.data() + i, 1);
+    }
+    assertEquals(RhAL::DynamixelV2::computeCRC(0, random.data(), len), crc);
+  }
+
+  LoopbackBus bus;
+  RhAL::DynamixelV2 protocol(bus);
+
+  // Ping
+  bus.response = { 0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26, 0x65, 0x5D };
+  assertEquals(protocol.ping(1), true);
+  assertEquals(bus.sent.size(), (size_t)10);
+  for (size_t i = 0; i < ping.size(); i++)
+  {
+    assertEquals(bus.sent[i], ping[i]);
+  }
+  assertEquals(bus.sent[8], (uint8_t)0x19);
+  assertEquals(bus.sent[9], (uint8_t)0x4E);
+
+  // Read with stuffed response parameters
+  // after some garbage bytes
+  bus.response = { 0xFF, 0x00, 0xFF, 0xFF };
+  std::vector<uint8_t> status = statusPacket(3, 0x00, { 0xFF, 0xFF, 0xFD, 0x12 });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  uint8_t data[4] = { 0 };
+  RhAL::ResponseState state = protocol.readData(3, 0x84, data, 4);
+  assertEquals(state, (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(data[0], (uint8_t)0xFF);
+  assertEquals(data[1], (uint8_t)0xFF);
+  assertEquals(data[2], (uint8_t)0xFD);
+  assertEquals(data[3], (uint8_t)0x12);
+
+  // Device error and bad id
+  bus.response = statusPacket(3, 0x02, {});
+  assertEquals(protocol.writeAndCheckData(3, 0x40, data, 1), (RhAL::ResponseState)RhAL::ResponseDeviceBadInstruction);
+  bus.response = statusPacket(4, 0x00, {});
+  assertEquals(protocol.writeAndCheckData(3, 0x40, data, 1), (RhAL::ResponseState)RhAL::ResponseBadId);
+
+  // Stuffing of written parameters
+  bus.response.clear();
+  uint8_t pattern[3] = { 0xFF, 0xFF, 0xFD };
+  protocol.writeData(1, 0x10, pattern, 3);
+  assertEquals(bus.sent.size(), (size_t)(8 + 2 + 4 + 2));
+  assertEquals(bus.sent[5], (uint8_t)(1 + 2 + 4 + 2));
+  assertEquals(bus.sent[13], (uint8_t)0xFD);
+
+  // Sync read with a missing device
+  uint8_t data1[2] = { 0 };
+  uint8_t data2[2] = { 0 };
+  uint8_t data3[2] = { 0 };
+  bus.response = statusPacket(1, 0x00, { 0x01, 0x02 });
+  status = statusPacket(3, 0x80, { 0x05, 0x06 });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  std::vector<RhAL::ResponseState> states = protocol.syncRead({ 1, 2, 3 }, 0x84, { data1, data2, data3 }, 2);
+  assertEquals(states.size(), (size_t)3);
+  assertEquals(states[0], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(states[1], (RhAL::ResponseState)RhAL::ResponseQuiet);
+  assertEquals(states[2], (RhAL::ResponseState)(RhAL::ResponseOK | RhAL::ResponseAlert));
+  assertEquals(data1[1], (uint8_t)0x02);
+  assertEquals(data3[0], (uint8_t)0x05);
+
+  // Bulk read with different addresses and lengths
+  uint8_t data4[4] = { 0 };
+  bus.response = statusPacket(1, 0x00, { 0x07 });
+  status = statusPacket(2, 0x00, { 0x08, 0x09, 0x0A, 0x0B });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  states = protocol.bulkRead({ 1, 2 }, { 0x40, 0x84 }, { data1, data4 }, { 1, 4 });
+  assertEquals(bus.sent[7], (uint8_t)0x92);
+  assertEquals(bus.sent[9], (uint8_t)0x40);
+  assertEquals(bus.sent[13], (uint8_t)0x02);
+  assertEquals(bus.sent[14], (uint8_t)0x84);
+  assertEquals(bus.sent[16], (uint8_t)0x04);
+  assertEquals(states.size(), (size_t)2);
+  assertEquals(states[0], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(states[1], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(data1[0], (uint8_t)0x07);
+  assertEquals(data4[3], (uint8_t)0x0B);
+
+  // Emergency stop writes the torque enable
+  // register of each model (XL320 id 1,
+  // XL430 id 2 and XM430 id 3)
+  bus.response = statusPacket(1, 0x00, { 0x5E, 0x01, 0x20 });
+  status = statusPacket(2, 0x00, { 0x24, 0x04, 0x2D });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  status = statusPacket(3, 0x00, { 0xFC, 0x03, 0x2D });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  bus.isRecording = true;
+  protocol.emergencyStop();
+  assertEquals(bus.packets.size(), (size_t)3);
+  assertEquals(bus.packets[0][4], (uint8_t)0xFE);
+  assertEquals(bus.packets[0][7], (uint8_t)0x01);
+  assertEquals(bus.packets[1][7], (uint8_t)0x83);
+  assertEquals(bus.packets[1][8], (uint8_t)0x18);
+  assertEquals(bus.packets[1].size(), (size_t)(12 + 2 + 2));
+  assertEquals(bus.packets[1][12], (uint8_t)1);
+  assertEquals(bus.packets[1][13], (uint8_t)0);
+  assertEquals(bus.packets[2][7], (uint8_t)0x83);
+  assertEquals(bus.packets[2][8], (uint8_t)0x40);
+  assertEquals(bus.packets[2].size(), (size_t)(12 + 4 + 2));
+  assertEquals(bus.packets[2][12], (uint8_t)2);
+  assertEquals(bus.packets[2][14], (uint8_t)3);
+  assertEquals(bus.packets[2][15], (uint8_t)0);
+  bus.packets.clear();
+  protocol.exitEmergencyState();
+  assertEquals(bus.packets.size(), (size_t)3);
+  assertEquals(bus.packets[1][13], (uint8_t)1);
+  assertEquals(bus.packets[2][15], (uint8_t)1);
+
+  // Known devices are stopped first, even
+  // when never answering the ping (X-series
+  // id 4). Known XL320 id 1 is not written
+  // twice and unsupported PRO id 5 is skipped.
+  protocol.parametersList().paramBool("pingUnknown").value = true;
+  bus.response = statusPacket(1, 0x00, { 0x5E, 0x01, 0x20 });
+  status = statusPacket(2, 0x00, { 0x24, 0x04, 0x2D });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  status = statusPacket(5, 0x00, { 0x08, 0xD3, 0x2D });
+  bus.response.insert(bus.response.end(), status.begin(), status.end());
+  bus.packets.clear();
+  protocol.emergencyStop({ 4, 1 }, { 0x40, 0x18 });
+  assertEquals(bus.packets.size(), (size_t)4);
+  assertEquals(bus.packets[0][7], (uint8_t)0x83);
+  assertEquals(bus.packets[0][8], (uint8_t)0x40);
+  assertEquals(bus.packets[0][12], (uint8_t)4);
+  assertEquals(bus.packets[0][13], (uint8_t)0);
+  assertEquals(bus.packets[1][8], (uint8_t)0x18);
+  assertEquals(bus.packets[1][12], (uint8_t)1);
+  assertEquals(bus.packets[2][7], (uint8_t)0x01);
+  assertEquals(bus.packets[3][8], (uint8_t)0x40);
+  assertEquals(bus.packets[3].size(), (size_t)(12 + 2 + 2));
+  assertEquals(bus.packets[3][12], (uint8_t)2);
+
+  // Torque is only enabled
+  // on known devices
+  bus.packets.clear();
+  protocol.exitEmergencyState({ 4, 1 }, { 0x40, 0x18 });
+  assertEquals(bus.packets.size(), (size_t)2);
+  assertEquals(bus.packets[0][13], (uint8_t)1);
+
+  // Without discovery, only
+  // known devices are written
+  protocol.parametersList().paramBool("pingUnknown").value = false;
+  bus.packets.clear();
+  protocol.emergencyStop({ 4, 1 }, { 0x40, 0x18 });
+  assertEquals(bus.packets.size(), (size_t)2);
+  assertEquals(bus.packets[0][12], (uint8_t)4);
+  assertEquals(bus.packets[1][12], (uint8_t)1);
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.setEnableSyncRead(true);
+  // Both temperatures are read at the same cycle
+  manager.setStaggerPeriodicReads(false);
+
+  // The budget is always exceeded by high priority
+  // position reads. Low priority temperature reads
+  // are deferred and promoted by one class every
+  // 4 deferrals until they are read.
+  manager.resetStatistics();
+  for (size_t i = 0; i < 8; i++)
+  {
+    manager.flush(true, 0.0005);
+    assertEquals(manager.dev<RhAL::ExampleDevice1>("dev1").temperature().needRead(), true);
+  }
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.readDeferredCount[RhAL::PriorityHigh], (unsigned long)0);
+  assertEquals(stats.readDeferredCount[RhAL::PriorityNormal], (unsigned long)0);
+  assertEquals(stats.readDeferredCount[RhAL::PriorityLow], (unsigned long)16);
+  assertEquals(stats.flushBudgetOverrunCount, (unsigned long)8);
+  assertEquals(stats.syncReadCount, (unsigned long)8);
+  manager.flush(true, 0.0005);
+  assertEquals(manager.dev<RhAL::ExampleDevice1>("dev1").temperature().needRead(), false);
+  stats = manager.getStatistics();
+  assertEquals(stats.readDeferredCount[RhAL::PriorityLow], (unsigned long)16);
+  assertEquals(stats.syncReadCount, (unsigned long)10);
+
+  // Large enough budget, nothing is deferred
+  manager.setFlushBudget(1.0);
+  manager.resetStatistics();
+  for (size_t i = 0; i < 8; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  assertEquals(stats.readDeferredCount[RhAL::PriorityLow], (unsigned long)0);
+  assertEquals(stats.flushBudgetOverrunCount, (unsigned long)0);
+  assertEquals(stats.syncReadCount, (unsigned long)10);
+
+  return 0;
+}
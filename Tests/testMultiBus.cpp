@@ -0,0 +1,112 @@
+#include <cstring>
+#include "Manager/Manager.hpp"
+#include "Protocol/DynamixelV1Simulator.hpp"
+#include "Devices/ExampleDevice1.hpp"
+#include "tests.h"
+
+float readFloat(const RhAL::DynamixelV1Simulator& simulator, RhAL::id_t id, RhAL::addr_t addr)
+{
+  float value;
+  simulator.readTable(id, addr, reinterpret_cast<uint8_t*>(&value), 4);
+  return value;
+}
+
+void writeFloat(RhAL::DynamixelV1Simulator& simulator, RhAL::id_t id, RhAL::addr_t addr, float value)
+{
+  simulator.writeTable(id, addr, reinterpret_cast<const uint8_t*>(&value), 4);
+}
+
+int main()
+{
+  // Two simulated buses with
+  // two devices on each
+  RhAL::DynamixelV1Simulator simulator1(1000000);
+  RhAL::DynamixelV1Simulator simulator2(1000000);
+  simulator1.addDevice(1);
+  simulator1.addDevice(2);
+  simulator2.addDevice(3);
+  simulator2.addDevice(4);
+
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.devAdd<RhAL::ExampleDevice1>(4, "dev4");
+  manager.dev<RhAL::ExampleDevice1>(3).parametersList().paramNumber("bus").value = 1;
+  manager.dev<RhAL::ExampleDevice1>(4).parametersList().paramNumber("bus").value = 1;
+  RhAL::BaseManager& baseManager = manager;
+  baseManager.parametersList().paramStr("bus").value = "NativeSerialBus";
+  baseManager.parametersList().paramStr("extraPorts").value = simulator2.port();
+  manager.setProtocolConfig(simulator1.port(), 1000000, "DynamixelV1");
+  assertEquals(manager.busCount(), (size_t)2);
+
+  // Direct operations are sent on the Device bus
+  assertEquals(manager.ping(1), true);
+  assertEquals(manager.ping(3), true);
+  unsigned long count1 = simulator1.packetCount();
+  unsigned long count2 = simulator2.packetCount();
+  assertEquals(manager.ping(4), true);
+  assertEquals(simulator1.packetCount(), count1);
+  assertEquals(simulator2.packetCount(), count2 + 1);
+
+  // Writes are sent on each bus
+  manager.dev<RhAL::ExampleDevice1>(1).goal().writeValue(1.5);
+  manager.dev<RhAL::ExampleDevice1>(2).goal().writeValue(2.5);
+  manager.dev<RhAL::ExampleDevice1>(3).goal().writeValue(3.5);
+  manager.dev<RhAL::ExampleDevice1>(4).goal().writeValue(4.5);
+  manager.flush();
+  assertEquals(readFloat(simulator1, 1, 4), 1.5f);
+  assertEquals(readFloat(simulator1, 2, 4), 2.5f);
+  assertEquals(readFloat(simulator2, 3, 4), 3.5f);
+  assertEquals(readFloat(simulator2, 4, 4), 4.5f);
+
+  // Reads are done on each bus
+  // and swapped at next flush
+  writeFloat(simulator1, 1, 8, 10.0);
+  writeFloat(simulator1, 2, 8, 20.0);
+  writeFloat(simulator2, 3, 8, 30.0);
+  writeFloat(simulator2, 4, 8, 40.0);
+  manager.flush();
+  manager.flush();
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(1).position().readValue().value, 10.0f);
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(2).position().readValue().value, 20.0f);
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(3).position().readValue().value, 30.0f);
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(4).position().readValue().value, 40.0f);
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.deviceQuarantineCount, (unsigned long)0);
+
+  // Device groups are written on their bus
+  RhAL::DeviceGroup& group = manager.addDeviceGroup({ 3, 4 }, "goal");
+  group.writeValues({ 5.5, 6.5 });
+  manager.flush();
+  assertEquals(group.needWrite(), false);
+  assertEquals(readFloat(simulator2, 3, 4), 5.5f);
+  assertEquals(readFloat(simulator2, 4, 4), 6.5f);
+
+  // Device groups are restricted to one bus
+  bool isThrown = false;
+  try
+  {
+    manager.addDeviceGroup({ 1, 3 }, "goal");
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+
+  // Invalid bus index
+  manager.dev<RhAL::ExampleDevice1>(4).parametersList().paramNumber("bus").value = 2;
+  isThrown = false;
+  try
+  {
+    manager.ping(4);
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <thread>
+#include "Bus/NativeSerialBus.hpp"
+#include "Protocol/DynamixelV1.hpp"
+#include "Protocol/DynamixelV1Simulator.hpp"
+#include "Manager/Manager.hpp"
+#include "Devices/ExampleDevice1.hpp"
+#include "tests.h"
+
+/**
+ * NativeSerialBus counting the sendData()
+ * and sendDataV() calls and the input
+ * buffer flushes
+ */
+class CountingBus : public RhAL::NativeSerialBus
+{
+public:
+  CountingBus(const std::string& port) : RhAL::NativeSerialBus(port, 1000000), sendCount(0), clearCount(0)
+  {
+  }
+  bool sendData(uint8_t* data, size_t size)
+  {
+    sendCount++;
+    return RhAL::NativeSerialBus::sendData(data, size);
+  }
+  bool sendDataV(const struct iovec* iov, size_t count)
+  {
+    sendCount++;
+    return RhAL::NativeSerialBus::sendDataV(iov, count);
+  }
+  void clearInputBuffer()
+  {
+    clearCount++;
+    RhAL::NativeSerialBus::clearInputBuffer();
+  }
+  size_t sendCount;
+  size_t clearCount;
+};
+
+int main()
+{
+  RhAL::DynamixelV1Simulator simulator(1000000);
+  simulator.addDevice(1);
+  simulator.addDevice(2);
+  CountingBus bus(simulator.port());
+  RhAL::DynamixelV1 protocol(bus);
+  protocol.parametersList().paramNumber("waitAfterWrite").value = 0.0;
+
+  // Without delay after writes, writes are
+  // queued and sent with the next read
+  // request in a single gather write
+  protocol.setPipelined(true);
+  assertEquals(protocol.isPipelined(), true);
+  uint8_t data1[2] = { 0x01, 0x02 };
+  uint8_t data2[2] = { 0x03, 0x04 };
+  protocol.writeData(1, 0x1E, data1, 2);
+  protocol.syncWrite({ 1, 2 }, 0x20, { data1, data2 }, 2);
+  assertEquals(bus.sendCount, (size_t)0);
+  assertEquals(bus.clearCount, (size_t)0);
+  uint8_t result[2] = { 0 };
+  RhAL::ResponseState state = protocol.readData(2, 0x20, result, 2);
+  assertEquals(bus.sendCount, (size_t)1);
+  assertEquals(bus.clearCount, (size_t)1);
+  assertEquals(state, (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(result[0], (uint8_t)0x03);
+  uint8_t table[2] = { 0 };
+  simulator.readTable(1, 0x1E, table, 2);
+  assertEquals(table[1], (uint8_t)0x02);
+
+  // With a delay after writes, queued
+  // writes are sent before the request
+  protocol.parametersList().paramNumber("waitAfterWrite").value = 0.0005;
+  bus.sendCount = 0;
+  protocol.writeData(1, 0x1E, data2, 2);
+  protocol.writeData(2, 0x1E, data1, 2);
+  assertEquals(protocol.ping(1), true);
+  assertEquals(bus.sendCount, (size_t)2);
+
+  // Disabling the mode sends queued writes
+  bus.sendCount = 0;
+  protocol.writeData(2, 0x1E, data2, 2);
+  protocol.setPipelined(false);
+  assertEquals(bus.sendCount, (size_t)1);
+  protocol.writeData(2, 0x1E, data1, 2);
+  assertEquals(bus.sendCount, (size_t)2);
+  protocol.readData(2, 0x1E, result, 2);
+  assertEquals(result[0], (uint8_t)0x01);
+
+  // Gather write of a ping split
+  // in several buffers
+  uint8_t ping[6] = { 0xff, 0xff, 0x02, 0x02, 0x01, (uint8_t)~(0x02 + 0x02 + 0x01) };
+  struct iovec iov[3] = { { ping, 2 }, { ping + 2, 0 }, { ping + 2, 4 } };
+  bus.clearInputBuffer();
+  assertEquals(bus.sendDataV(iov, 3), true);
+  assertEquals(bus.waitForData(0.1), true);
+  bus.clearInputBuffer();
+
+  // Sync write chunks leave in a single transfer
+  std::vector<RhAL::id_t> ids;
+  std::vector<const uint8_t*> datas;
+  uint8_t block[32] = { 0 };
+  block[31] = 0x42;
+  for (RhAL::id_t id = 1; id <= 12; id++)
+  {
+    ids.push_back(id);
+    datas.push_back(block);
+    if (id > 2)
+    {
+      simulator.addDevice(id);
+    }
+  }
+  bus.sendCount = 0;
+  protocol.syncWrite(ids, 0x40, datas, 32);
+  assertEquals(bus.sendCount, (size_t)1);
+  assertEquals(protocol.isPipelined(), false);
+  protocol.readData(12, 0x5F, result, 1);
+  assertEquals(result[0], (uint8_t)0x42);
+
+  // Pipelined Manager flush
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  RhAL::BaseManager& baseManager = manager;
+  baseManager.parametersList().paramStr("bus").value = "NativeSerialBus";
+  manager.setProtocolConfig(simulator.port(), 1000000, "DynamixelV1");
+  // Writes and the first read request
+  // leave in a single gather write
+  manager.protocolParametersList().paramNumber("waitAfterWrite").value = 0.0;
+  manager.setEnableSyncWrite(false);
+  manager.setPipelineWrites(true);
+  manager.dev<RhAL::ExampleDevice1>(1).goal().writeValue(1.5);
+  manager.dev<RhAL::ExampleDevice1>(2).goal().writeValue(2.5);
+  float position = 3.5;
+  simulator.writeTable(2, 8, reinterpret_cast<const uint8_t*>(&position), 4);
+  manager.flush();
+  manager.flush();
+  float goal;
+  simulator.readTable(1, 4, reinterpret_cast<uint8_t*>(&goal), 4);
+  assertEquals(goal, 1.5f);
+  simulator.readTable(2, 4, reinterpret_cast<uint8_t*>(&goal), 4);
+  assertEquals(goal, 2.5f);
+  assertEquals(manager.dev<RhAL::ExampleDevice1>(2).position().readValue().value, 3.5f);
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.writeCount, (unsigned long)2);
+
+  // A forced write during pipelined flushes
+  // is sent before the call returns and never
+  // left behind in the flush queue
+  std::atomic<bool> isFlushing(true);
+  std::thread flushThread([&manager, &isFlushing]() {
+    while (isFlushing)
+    {
+      manager.flush();
+    }
+  });
+  manager.resetStatistics();
+  for (unsigned int i = 0; i < 200; i++)
+  {
+    manager.dev<RhAL::ExampleDevice1>(2).goal().writeValue(i);
+    manager.dev<RhAL::ExampleDevice1>(2).goal().forceWrite();
+    RhAL::TimePoint deadline = RhAL::getTimePoint() + std::chrono::milliseconds(50);
+    do
+    {
+      simulator.readTable(2, 4, reinterpret_cast<uint8_t*>(&goal), 4);
+    } while (goal != (float)i && RhAL::getTimePoint() < deadline);
+    assertEquals(goal, (float)i);
+  }
+  isFlushing = false;
+  flushThread.join();
+  stats = manager.getStatistics();
+  assertEquals(stats.forceWriteCount, (unsigned long)200);
+
+  return 0;
+}
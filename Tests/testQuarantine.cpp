@@ -0,0 +1,51 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.setQuarantineFailures(3);
+  // Device 2 stops answering
+  manager.protocolParametersList().paramNumber("quietId").value = 2;
+  manager.protocolParametersList().paramBool("pingAnswer").value = true;
+
+  manager.flush();
+  assertEquals(manager.dev("dev2").isQuarantined(), false);
+  manager.flush();
+  manager.flush();
+  assertEquals(manager.dev("dev1").isQuarantined(), false);
+  assertEquals(manager.dev("dev2").isQuarantined(), true);
+  assertEquals(manager.dev("dev2").countQuarantines(), (unsigned long)1);
+  assertEquals(manager.getStatistics().deviceQuarantineCount, (unsigned long)1);
+
+  // The quarantined Device is excluded from
+  // reads and probed with exponential backoff
+  // (quarantined at cycle 1, probed at cycles
+  // 2, 4, 8, 16, 32)
+  manager.resetStatistics();
+  for (size_t i = 0; i < 16; i++)
+  {
+    manager.flush();
+  }
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.deviceQuietCount, (unsigned long)0);
+  assertEquals(stats.quarantineProbeCount, (unsigned long)3);
+  assertEquals(manager.dev("dev2").isQuarantined(), true);
+
+  // The Device answers again and is readmitted
+  manager.protocolParametersList().paramNumber("quietId").value = 0;
+  for (size_t i = 0; i < 16; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  assertEquals(stats.deviceReadmitCount, (unsigned long)1);
+  assertEquals(manager.dev("dev2").isQuarantined(), false);
+  assertEquals(manager.dev("dev2").isPresent(), true);
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <thread>
+#include <chrono>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+
+  // Fixed rate cycles at 100Hz
+  manager.setSchedulerConfig(100.0);
+  manager.resetStatistics();
+  manager.startManagerThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  manager.stopManagerThread();
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.schedulerPeriodCount >= 40, true);
+  assertEquals(stats.schedulerPeriodCount <= 51, true);
+  unsigned long sum = 0;
+  for (size_t i = 0; i < RhAL::SchedulerJitterBuckets; i++)
+  {
+    sum += stats.schedulerJitterHistogram[i];
+  }
+  assertEquals(sum, stats.schedulerPeriodCount);
+  assertEquals(stats.schedulerJitterPercentile(0.5) <= stats.maxSchedulerJitter.count(), true);
+
+  // Unreachable frequency misses deadlines
+  manager.setSchedulerConfig(1e6);
+  manager.resetStatistics();
+  manager.startManagerThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  manager.stopManagerThread();
+  stats = manager.getStatistics();
+  assertEquals(stats.schedulerDeadlineMissCount > 0, true);
+
+  // Free running mode does not
+  // update scheduler statistics
+  manager.setSchedulerConfig(0.0);
+  manager.resetStatistics();
+  manager.startManagerThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  manager.stopManagerThread();
+  stats = manager.getStatistics();
+  assertEquals(stats.schedulerPeriodCount, (unsigned long)0);
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "Bus/NativeSerialBus.hpp"
+#include "Protocol/DynamixelV1.hpp"
+#include "Protocol/DynamixelV1Simulator.hpp"
+#include "tests.h"
+
+int main()
+{
+  // Slow baudrate to check timing emulation
+  RhAL::DynamixelV1Simulator simulator(57600);
+  simulator.addDevice(1);
+  simulator.addDevice(2);
+  RhAL::NativeSerialBus bus(simulator.port(), 57600);
+  RhAL::DynamixelV1 protocol(bus);
+
+  // Ping
+  assertEquals(protocol.ping(1), true);
+  assertEquals(protocol.ping(2), true);
+  assertEquals(protocol.ping(3), false);
+
+  // Write then read back
+  uint8_t data[2] = { 0x34, 0x12 };
+  protocol.writeData(1, 0x1E, data, 2);
+  uint8_t result[2] = { 0 };
+  RhAL::TimePoint start = RhAL::getTimePoint();
+  RhAL::ResponseState state = protocol.readData(1, 0x1E, result, 2);
+  double duration = RhAL::duration_float(start, RhAL::getTimePoint());
+  assertEquals(state, (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(result[0], (uint8_t)0x34);
+  assertEquals(result[1], (uint8_t)0x12);
+  uint8_t table[2] = { 0 };
+  simulator.readTable(1, 0x1E, table, 2);
+  assertEquals(table[1], (uint8_t)0x12);
+  // Request (8 bytes) and response (8 bytes) transmission
+  assertEquals(duration > 16 * 10.0 / 57600, true);
+
+  // Return delay time
+  uint8_t delay = 250;
+  simulator.writeTable(2, RhAL::DynamixelV1Simulator::AddrReturnDelay, &delay, 1);
+  start = RhAL::getTimePoint();
+  assertEquals(protocol.ping(2), true);
+  duration = RhAL::duration_float(start, RhAL::getTimePoint());
+  assertEquals(duration > 0.0005, true);
+
+  // Sync write and sync read
+  uint8_t data1[2] = { 0x01, 0x02 };
+  uint8_t data2[2] = { 0x03, 0x04 };
+  protocol.syncWrite({ 1, 2 }, 0x20, { data1, data2 }, 2);
+  uint8_t read1[2] = { 0 };
+  uint8_t read2[2] = { 0 };
+  uint8_t read3[2] = { 0 };
+  std::vector<RhAL::ResponseState> states = protocol.syncRead({ 1, 2, 3 }, 0x20, { read1, read2, read3 }, 2);
+  assertEquals(states[0], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(states[1], (RhAL::ResponseState)RhAL::ResponseOK);
+  assertEquals(states[2], (RhAL::ResponseState)RhAL::ResponseQuiet);
+  assertEquals(read1[1], (uint8_t)0x02);
+  assertEquals(read2[0], (uint8_t)0x03);
+
+  // Broadcast write
+  uint8_t torque = 1;
+  protocol.writeData(RhAL::Broadcast, 0x18, &torque, 1);
+  states = protocol.syncRead({ 1, 2 }, 0x18, { read1, read2 }, 1);
+  assertEquals(read1[0], (uint8_t)1);
+  assertEquals(read2[0], (uint8_t)1);
+  assertEquals(simulator.packetCount() > 0, true);
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/RX64.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::RX64> manager;
+  manager.devAdd<RhAL::RX64>(1, "dev1");
+  manager.devAdd<RhAL::RX64>(2, "dev2");
+  manager.flush();
+
+  // Writing an EEPROM register does not
+  // block the flush but only its Device.
+  // The other Device batched with it is
+  // still read during this flush.
+  manager.resetStatistics();
+  manager.dev<RhAL::RX64>("dev1").temperatureLimit().writeValue(70);
+  manager.dev<RhAL::RX64>("dev1").position().askRead();
+  manager.dev<RhAL::RX64>("dev2").position().askRead();
+  RhAL::TimePoint pStart = RhAL::getTimePoint();
+  manager.flush();
+  RhAL::TimePoint pStop = RhAL::getTimePoint();
+  assertEquals(RhAL::duration_float(pStart, pStop) < RhAL::SlowRegisterDelayMs / 2000.0, true);
+  assertEquals(manager.dev("dev1").isBusy(), true);
+  assertEquals(manager.dev("dev2").isBusy(), false);
+  assertEquals(manager.dev<RhAL::RX64>("dev1").position().needRead(), true);
+  assertEquals(manager.dev<RhAL::RX64>("dev2").position().needRead(), false);
+
+  // Only the other Device is read
+  // during the write window
+  manager.dev<RhAL::RX64>("dev1").position().askRead();
+  manager.dev<RhAL::RX64>("dev2").position().askRead();
+  manager.flush();
+  assertEquals(manager.dev<RhAL::RX64>("dev1").position().needRead(), true);
+  assertEquals(manager.dev<RhAL::RX64>("dev2").position().needRead(), false);
+
+  // The Device is readmitted at
+  // the end of the write window
+  std::this_thread::sleep_for(std::chrono::milliseconds(RhAL::SlowRegisterDelayMs + 10));
+  manager.flush();
+  assertEquals(manager.dev("dev1").isBusy(), false);
+  manager.flush();
+  assertEquals(manager.dev<RhAL::RX64>("dev1").position().needRead(), false);
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.slowWriteCount, (unsigned long)1);
+  assertEquals(stats.slowWriteProbeReleaseCount, (unsigned long)0);
+  assertEquals(RhAL::duration_float(stats.sumDeviceBusyDuration) >= RhAL::SlowRegisterDelayMs / 1000.0, true);
+
+  // With readiness probe, the Device is
+  // readmitted as soon as it answers a ping
+  manager.setSlowWriteProbe(true);
+  manager.protocolParametersList().paramBool("pingAnswer").value = true;
+  manager.dev<RhAL::RX64>("dev2").temperatureLimit().writeValue(70);
+  manager.flush();
+  assertEquals(manager.dev("dev2").isBusy(), false);
+  stats = manager.getStatistics();
+  assertEquals(stats.slowWriteCount, (unsigned long)2);
+  assertEquals(stats.slowWriteProbeReleaseCount, (unsigned long)1);
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <cmath>
+#include <set>
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+#include "Devices/ExampleDevice2.hpp"
+#include "Devices/MX64.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1, RhAL::ExampleDevice2> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice2>(3, "dev3");
+  assertEquals(manager.snapshot() == nullptr, true);
+
+  manager.setSnapshotRegisters({ "position", "temperature" });
+  manager.flush();
+  std::shared_ptr<const RhAL::StateSnapshot> snapshot = manager.snapshot();
+  assertEquals(snapshot->ids.size(), (size_t)3);
+  assertEquals(snapshot->names.size(), (size_t)2);
+  assertEquals(snapshot->values.size(), (size_t)6);
+  assertEquals(snapshot->index(3), (size_t)2);
+  // Columns are contiguous per Register
+  size_t column = snapshot->column("position");
+  for (RhAL::id_t id = 1; id <= 2; id++)
+  {
+    RhAL::ReadValueFloat value = manager.dev<RhAL::ExampleDevice1>(id).position().lastReadValue();
+    assertEquals(snapshot->columnValues(column)[id - 1], value.value);
+    assertEquals(snapshot->columnTimestamps(column)[id - 1] == value.timestamp, true);
+    assertEquals(snapshot->columnErrors(column)[id - 1], (uint8_t)0);
+  }
+  // Missing Register
+  assertEquals(std::isnan(snapshot->value("temperature", 3)), true);
+  assertEquals(snapshot->columnErrors(snapshot->column("temperature"))[2], (uint8_t)1);
+
+  // A held snapshot is never modified
+  unsigned long cycle = snapshot->cycle;
+  manager.flush();
+  assertEquals(snapshot->cycle, cycle);
+  assertEquals(manager.snapshot()->cycle > cycle, true);
+  snapshot.reset();
+
+  // Buffers are reused when not held
+  std::set<const RhAL::StateSnapshot*> buffers;
+  for (size_t i = 0; i < 8; i++)
+  {
+    manager.flush();
+    buffers.insert(manager.snapshot().get());
+  }
+  assertEquals(buffers.size() <= 2, true);
+
+  // Only float Registers
+  RhAL::Manager<RhAL::MX64> managerMX;
+  managerMX.devAdd<RhAL::MX64>(1, "dev1");
+  bool isThrown = false;
+  try
+  {
+    managerMX.setSnapshotRegisters({ "torqueEnable" });
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+/**
+ * Return the maximum and the sum of
+ * periodic reads predicted load
+ */
+static unsigned long maxLoad(const RhAL::Statistics& stats)
+{
+  unsigned long load = 0;
+  for (size_t i = 0; i < stats.periodicReadLoad.size(); i++)
+  {
+    load = std::max(load, stats.periodicReadLoad[i]);
+  }
+  return load;
+}
+static unsigned long sumLoad(const RhAL::Statistics& stats)
+{
+  unsigned long load = 0;
+  for (size_t i = 0; i < stats.periodicReadLoad.size(); i++)
+  {
+    load += stats.periodicReadLoad[i];
+  }
+  return load;
+}
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  manager.devAdd<RhAL::ExampleDevice1>(3, "dev3");
+  manager.devAdd<RhAL::ExampleDevice1>(4, "dev4");
+
+  // Position (4 bytes) is read every cycle and
+  // temperature (4 bytes) every 4 cycles. Each
+  // Device temperature is read at its own cycle.
+  manager.flush();
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.periodicReadLoad.size(), (size_t)4);
+  assertEquals(maxLoad(stats), (unsigned long)20);
+  assertEquals(sumLoad(stats), (unsigned long)80);
+  for (size_t i = 0; i < 4; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  assertEquals(stats.regReadPerFlushMax, (unsigned long)5);
+  // Positions are sync read at each cycle and
+  // one temperature is read alone per cycle
+  assertEquals(stats.syncReadCount, (unsigned long)5);
+  assertEquals(stats.readCount, (unsigned long)5);
+
+  // Without staggering, all temperatures are read
+  // at the same cycle. Mean load is unchanged.
+  manager.setStaggerPeriodicReads(false);
+  manager.resetStatistics();
+  for (size_t i = 0; i < 5; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  assertEquals(maxLoad(stats), (unsigned long)32);
+  assertEquals(sumLoad(stats), (unsigned long)80);
+  assertEquals(stats.regReadPerFlushMax, (unsigned long)8);
+
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include "Manager/Manager.hpp"
+#include "tests.h"
+#include "Devices/ExampleDevice1.hpp"
+
+int main()
+{
+  RhAL::Manager<RhAL::ExampleDevice1> manager;
+  manager.devAdd<RhAL::ExampleDevice1>(1, "dev1");
+  manager.devAdd<RhAL::ExampleDevice1>(2, "dev2");
+  // The flush rate is the scheduler frequency
+  manager.setSchedulerConfig(100.0);
+  RhAL::ExampleDevice1& dev1 = manager.dev<RhAL::ExampleDevice1>("dev1");
+  RhAL::ExampleDevice1& dev2 = manager.dev<RhAL::ExampleDevice1>("dev2");
+
+  // Default read periods
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 1u);
+  assertEquals(dev1.temperature().readPeriod(), 4u);
+
+  // The highest subscribed rate is used
+  size_t slow = manager.subscribeRead(1, "position", 25.0);
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 4u);
+  size_t fast = manager.subscribeRead(1, "position", 50.0);
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 2u);
+  manager.unsubscribeRead(fast);
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 4u);
+
+  // A non periodic register can be subscribed
+  size_t goal = manager.subscribeRead(2, "goal", RhAL::ReadEveryCycle);
+  manager.flush();
+  assertEquals(dev2.goal().readPeriod(), 1u);
+  manager.resetStatistics();
+  for (size_t i = 0; i < 4; i++)
+  {
+    manager.flush();
+  }
+  RhAL::Statistics stats = manager.getStatistics();
+  assertEquals(stats.regReadPerFlushMax >= 2, true);
+
+  // Registers without subscription are
+  // no longer read if asked
+  manager.setSubscribedReadsOnly(true);
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 4u);
+  assertEquals(dev1.temperature().readPeriod(), 0u);
+  assertEquals(dev2.position().readPeriod(), 0u);
+  manager.resetStatistics();
+  for (size_t i = 0; i < 8; i++)
+  {
+    manager.flush();
+  }
+  stats = manager.getStatistics();
+  // dev2 goal at each cycle and
+  // dev1 position every 4 cycles
+  assertEquals(stats.readCount, (unsigned long)(8 + 2));
+
+  // Default periods are restored
+  manager.unsubscribeRead(slow);
+  manager.unsubscribeRead(goal);
+  manager.setSubscribedReadsOnly(false);
+  manager.flush();
+  assertEquals(dev1.position().readPeriod(), 1u);
+  assertEquals(dev2.goal().readPeriod(), 0u);
+
+  // Invalid subscriptions
+  bool isThrown = false;
+  try
+  {
+    manager.unsubscribeRead(goal);
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+  isThrown = false;
+  try
+  {
+    manager.subscribeRead(1, "position", 0.0);
+  }
+  catch (const std::logic_error&)
+  {
+    isThrown = true;
+  }
+  assertEquals(isThrown, true);
+
+  return 0;
+}